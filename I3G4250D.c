@@ -17,170 +17,2361 @@ References:
 
 #include "I3G4250D.h"
 
-//CS Pin used in my STM32F429ZI, change according to needs
-#define _CS_PIN GPIO_PIN_1
-#define _I3G4250D_CS_ENABLE HAL_GPIO_WritePin(GPIOC, _CS_PIN, GPIO_PIN_RESET)
-#define _I3G4250D_CS_DISABLE HAL_GPIO_WritePin(GPIOC, _CS_PIN, GPIO_PIN_SET)
+// Chip select of a gyroscope
+#define _I3G4250D_CS_ENABLE(gyro) I3G4250D_CS_WRITE((gyro)->CS_Port, (gyro)->CS_Pin, GPIO_PIN_RESET)
+#define _I3G4250D_CS_DISABLE(gyro) I3G4250D_CS_WRITE((gyro)->CS_Port, (gyro)->CS_Pin, GPIO_PIN_SET)
 
-// SPI Handle
-static SPI_HandleTypeDef SPI_Handle;
+// CIC decimation of the DMA completion path
+static size_t I3G4250D_Decimate(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *in, size_t n, size_t *last);
+static void I3G4250D_TempUpdate(I3G4250D_HandleTypeDef *gyro, uint8_t raw);
+static bool I3G4250D_AdaptiveOdrDecide(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *samples, size_t n);
 
-// Sensitivty
-static float I3G4250D_Sensitivity = I3G4250D_SENSITIVTY_17_50;
+// Instrumentation hooks, compiled out unless I3G4250D_ENABLE_STATS is defined
+#ifdef I3G4250D_ENABLE_STATS
+static void I3G4250D_StatsTransaction(I3G4250D_HandleTypeDef *gyro, bool read, uint32_t start, HAL_StatusTypeDef status);
+static void I3G4250D_StatsSamples(I3G4250D_HandleTypeDef *gyro, size_t count);
+static void I3G4250D_StatsStatus(I3G4250D_HandleTypeDef *gyro, HAL_StatusTypeDef status);
+#define _I3G4250D_STATS_START() I3G4250D_GetTimestamp()
+#define _I3G4250D_STATS_TRANSACTION(gyro, read, start, status) I3G4250D_StatsTransaction((gyro), (read), (start), (status))
+#define _I3G4250D_STATS_SAMPLES(gyro, count) I3G4250D_StatsSamples((gyro), (count))
+#define _I3G4250D_STATS_STATUS(gyro, status) I3G4250D_StatsStatus((gyro), (status))
+#define _I3G4250D_STATS_POLL(gyro) ((gyro)->stats.pollIterations++)
+#else
+#define _I3G4250D_STATS_START() 0
+#define _I3G4250D_STATS_TRANSACTION(gyro, read, start, status) ((void)(read), (void)(start), (void)(status))
+#define _I3G4250D_STATS_SAMPLES(gyro, count) ((void)0)
+#define _I3G4250D_STATS_STATUS(gyro, status) ((void)(status))
+#define _I3G4250D_STATS_POLL(gyro) ((void)0)
+#endif
 
-// Bias and scaling
-static float X_Bias = 0.0f;
-static float Y_Bias = 0.0f;
-static float Z_Bias = 0.0f;
+// Initialized gyroscopes, used to dispatch the SPI completion handlers
+static I3G4250D_HandleTypeDef *I3G4250D_Instances[I3G4250D_MAX_INSTANCES];
 
-static float X_Scale = 0.0f;
-static float Y_Scale = 0.0f;
-static float Z_Scale = 0.0f;
+// Decode the 6 output bytes (OUT_X_L..OUT_Z_H) of one sample, axes missing from axisMask read as 0
+static void I3G4250D_DecodeSample(const uint8_t *data, uint8_t axisMask, I3G4250D_DataRaw *sample)
+{
+    sample->x = (axisMask & 0x01) ? (int16_t)((data[1] << 8) | data[0]) : 0;
+    sample->y = (axisMask & 0x02) ? (int16_t)((data[3] << 8) | data[2]) : 0;
+    sample->z = (axisMask & 0x04) ? (int16_t)((data[5] << 8) | data[4]) : 0;
+}
 
-void I3G4250D_WriteIO(uint8_t registerAddress, uint8_t *writeData, uint8_t size)
+HAL_StatusTypeDef I3G4250D_WriteIO(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress, uint8_t *writeData, uint16_t size)
 {
     uint32_t timeOut = 10;
     uint8_t spiRegisterAddress = registerAddress;
+    uint32_t start = _I3G4250D_STATS_START();
+    HAL_StatusTypeDef status = I3G4250D_BUS_LOCK(gyro->SPI_Handle);
+    if (status != HAL_OK)
+    {
+        _I3G4250D_STATS_STATUS(gyro, status);
+        return status;
+    }
     // Enable Chip Select or Slave Select (CS / SS)
-    _I3G4250D_CS_ENABLE;
+    _I3G4250D_CS_ENABLE(gyro);
     // Set register values
-    HAL_SPI_Transmit(&SPI_Handle, &spiRegisterAddress, 1, timeOut);
+    status = I3G4250D_BUS_TRANSMIT(gyro->SPI_Handle, &spiRegisterAddress, 1, timeOut);
     // Transmite write data
-    HAL_SPI_Transmit(&SPI_Handle, writeData, size, timeOut);
+    if (status == HAL_OK)
+    {
+        status = I3G4250D_BUS_TRANSMIT(gyro->SPI_Handle, writeData, size, timeOut);
+    }
     // Disable Chip select
-    _I3G4250D_CS_DISABLE;
+    _I3G4250D_CS_DISABLE(gyro);
+    I3G4250D_BUS_UNLOCK(gyro->SPI_Handle);
+    _I3G4250D_STATS_TRANSACTION(gyro, false, start, status);
+
+    return status;
+}
+
+HAL_StatusTypeDef I3G4250D_ReadIO(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress, uint8_t *readData, uint16_t size)
+{
+    uint32_t msTimeOut = 10;
+    uint8_t spiRegisterAddress = registerAddress | I3G4250D_SPI_READ;
+    uint32_t start = _I3G4250D_STATS_START();
+    HAL_StatusTypeDef status = I3G4250D_BUS_LOCK(gyro->SPI_Handle);
+    if (status != HAL_OK)
+    {
+        _I3G4250D_STATS_STATUS(gyro, status);
+        return status;
+    }
+    if (size > 1)
+    {
+        spiRegisterAddress |= I3G4250D_SPI_AUTO_INCREMENT;
+    }
+    _I3G4250D_CS_ENABLE(gyro);
+    status = I3G4250D_BUS_TRANSMIT(gyro->SPI_Handle, &spiRegisterAddress, 1, msTimeOut);
+    // Receive straight into the caller's buffer
+    if (status == HAL_OK)
+    {
+        status = I3G4250D_BUS_RECEIVE(gyro->SPI_Handle, readData, size, msTimeOut);
+    }
+    _I3G4250D_CS_DISABLE(gyro);
+    I3G4250D_BUS_UNLOCK(gyro->SPI_Handle);
+    _I3G4250D_STATS_TRANSACTION(gyro, true, start, status);
+
+    return status;
 }
 
-void I3G4250D_ReadIO(uint8_t registerAddress, uint8_t *readData, uint8_t size)
+HAL_StatusTypeDef I3G4250D_TransferIO(I3G4250D_HandleTypeDef *gyro, uint8_t *frame, uint16_t size)
 {
     uint32_t msTimeOut = 10;
-    uint8_t spiBuffer[4];
-    spiBuffer[0] = registerAddress | 0x80;
-    _I3G4250D_CS_ENABLE;
-    HAL_SPI_Transmit(&SPI_Handle, spiBuffer, 1, msTimeOut);
-    HAL_SPI_Receive(&SPI_Handle, spiBuffer, size, msTimeOut);
-    _I3G4250D_CS_DISABLE;
+    // The address byte is overwritten by the transfer, decide the direction first
+    bool read = (frame[0] & I3G4250D_SPI_READ) != 0;
+    uint32_t start = _I3G4250D_STATS_START();
+    HAL_StatusTypeDef status = I3G4250D_BUS_LOCK(gyro->SPI_Handle);
 
-    for (uint8_t i = 0; i < (size & 0x3); i++)
+    if (status != HAL_OK)
     {
-        readData[i] = spiBuffer[i];
+        _I3G4250D_STATS_STATUS(gyro, status);
+        return status;
     }
+    // Transmit and receive in place, every byte is sent before the byte received in its slot overwrites it
+    _I3G4250D_CS_ENABLE(gyro);
+    status = I3G4250D_BUS_TRANSFER(gyro->SPI_Handle, frame, frame, size, msTimeOut);
+    _I3G4250D_CS_DISABLE(gyro);
+    I3G4250D_BUS_UNLOCK(gyro->SPI_Handle);
+    _I3G4250D_STATS_TRANSACTION(gyro, read, start, status);
+
+    return status;
 }
 
-void I3G4250D_Init(SPI_HandleTypeDef *accelerometerSPI, I3G4250D_InitTypeDef *accelerometerInit)
+// Position of a register in the shadow cache, -1 if it is not cached
+static int8_t I3G4250D_ShadowIndex(uint8_t registerAddress)
 {
-    uint8_t spiData = 0;
-    memcpy(&SPI_Handle, accelerometerSPI, sizeof(*accelerometerSPI));
+    if (registerAddress >= I3G4250D_CTRL_REG1 && registerAddress <= I3G4250D_CTRL_REG5)
+    {
+        return (int8_t)(registerAddress - I3G4250D_CTRL_REG1);
+    }
+    if (registerAddress == I3G4250D_FIFO_CTRL_REG)
+    {
+        return 5;
+    }
+    if (registerAddress == I3G4250D_INT1_CFG_REG)
+    {
+        return 6;
+    }
+    return -1;
+}
 
-    //** 1. Enable all axis on the gyroscope and set output datarate and bandwidth preset**//
-    spiData |= (accelerometerInit->ENABLED_AXIS & 0x0F);
-    spiData |= (accelerometerInit->ODR_BW_PRESET & 0xF0);
-    // set values of CTRL_REG1 of the I3G4250D
-    I3G4250D_WriteIO(I3G4250D_CTRL_REG1, &spiData, 1);
+// Write consecutive registers in one transaction, without looking at the shadow cache.
+// A failed transfer leaves the cached registers it covered in an unknown state, they are marked stale until written successfully.
+static HAL_StatusTypeDef I3G4250D_PushRegisters(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress, const uint8_t *values, uint8_t count)
+{
+    uint8_t frame[1 + 16];
+    HAL_StatusTypeDef status;
 
-    //** 2. Set the High Pass filter mode and High pass filter frequency cutoff **//
-    // Reset SpiData
-    spiData = 0;
-    spiData |= (accelerometerInit->HPF_MODE & 0x30);
-    spiData |= (accelerometerInit->HPCF_MODE & 0x0F);
-    // set values of CTRL_REG2 of the I3G4250D
-    I3G4250D_WriteIO(I3G4250D_CTRL_REG2, &spiData, 1);
-
-    //** 3. Set 4-wire SPI, Full scale selection and self test mode
-    spiData = 0;
-    spiData |= (accelerometerInit->FULLSCALE_SELECTION & 0x30);
-    // Set the self test mode to normal and the SPI mode to 4 wire.
-    spiData |= (0x00 & 0x00);
-    // set values of CTRL_REG4 of the I3G4250D
-    I3G4250D_WriteIO(I3G4250D_CTRL_REG4, &spiData, 1);
+    if (count == 0 || count > 16)
+    {
+        return HAL_ERROR;
+    }
+    frame[0] = registerAddress;
+    if (count > 1)
+    {
+        frame[0] |= I3G4250D_SPI_AUTO_INCREMENT;
+    }
+    memcpy(&frame[1], values, count);
+    status = I3G4250D_TransferIO(gyro, frame, (uint16_t)(1 + count));
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        int8_t index = I3G4250D_ShadowIndex((uint8_t)(registerAddress + i));
+        if (index < 0)
+        {
+            continue;
+        }
+        if (status == HAL_OK)
+        {
+            gyro->shadowStale &= (uint8_t)~(1U << index);
+        }
+        else
+        {
+            gyro->shadowStale |= (uint8_t)(1U << index);
+        }
+    }
+    return status;
+}
+
+// Write the whole shadow cache to the gyroscope, returns the first failure.
+// Registers after a failed transfer are not attempted, so they stay stale as well.
+static HAL_StatusTypeDef I3G4250D_PushShadow(I3G4250D_HandleTypeDef *gyro)
+{
+    HAL_StatusTypeDef status;
+
+    gyro->shadowStale = (uint8_t)((1U << I3G4250D_SHADOW_SIZE) - 1);
+    status = I3G4250D_PushRegisters(gyro, I3G4250D_CTRL_REG1, &gyro->shadow[0], 5);
+    if (status == HAL_OK)
+    {
+        status = I3G4250D_PushRegisters(gyro, I3G4250D_FIFO_CTRL_REG, &gyro->shadow[5], 1);
+    }
+    if (status == HAL_OK)
+    {
+        status = I3G4250D_PushRegisters(gyro, I3G4250D_INT1_CFG_REG, &gyro->shadow[6], 1);
+    }
+    return status;
+}
+
+// Sample period at the output data rate in CTRL_REG1
+static void I3G4250D_UpdateTiming(I3G4250D_HandleTypeDef *gyro)
+{
+    gyro->samplePeriod = I3G4250D_GetTimestampFrequency() / I3G4250D_GetODR(gyro);
+}
+
+// Shortest single sample burst for the axes enabled in CTRL_REG1, see I3G4250D_GetRawData
+static void I3G4250D_UpdateAxes(I3G4250D_HandleTypeDef *gyro)
+{
+    uint8_t axisMask = gyro->shadow[0] & 0x07;
+    uint8_t first;
+    uint8_t last;
+
+    if (axisMask == 0)
+    {
+        axisMask = 0x07;
+    }
+    first = (axisMask & 0x01) ? 0 : ((axisMask & 0x02) ? 1 : 2);
+    last = (axisMask & 0x04) ? 2 : ((axisMask & 0x02) ? 1 : 0);
+
+    // Offset of the address byte in an OUT_TEMP + STATUS_REG + 6 byte frame so every axis lands in its usual slot.
+    // STATUS_REG directly precedes OUT_X_L, so it is only part of the burst when X is enabled, OUT_TEMP only with temperature compensation.
+    if (gyro->tempComp.enabled)
+    {
+        gyro->axisFrameOffset = 0;
+    }
+    else
+    {
+        gyro->axisFrameOffset = (first == 0) ? 1 : (uint8_t)(2 + (2 * first));
+    }
+    gyro->axisFrameSize = (uint8_t)(3 + (2 * (last + 1)) - gyro->axisFrameOffset);
+    if (axisMask != gyro->axisMask)
+    {
+        gyro->axisMask = axisMask;
+        I3G4250D_UpdateGain(gyro);
+    }
+}
+
+// FIFO enabled and not in bypass mode
+static bool I3G4250D_FifoEnabled(I3G4250D_HandleTypeDef *gyro)
+{
+    return (gyro->shadow[4] & I3G4250D_CTRL_REG5_FIFO_EN) && (gyro->shadow[5] & 0xE0) != I3G4250D_FIFO_MODE_BYPASS;
+}
+
+uint32_t I3G4250D_GetODR(I3G4250D_HandleTypeDef *gyro)
+{
+    static const uint16_t odrHz[4] = {I3G4250D_ODR_HZ_DR_00, I3G4250D_ODR_HZ_DR_01, I3G4250D_ODR_HZ_DR_10, I3G4250D_ODR_HZ_DR_11};
+
+    return odrHz[gyro->shadow[0] >> 6];
+}
+
+__weak void I3G4250D_TimestampInit(void)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+__weak uint32_t I3G4250D_GetTimestamp(void)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+    return DWT->CYCCNT;
+#else
+    return I3G4250D_GET_TICK();
+#endif
+}
+
+__weak uint32_t I3G4250D_GetTimestampFrequency(void)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+    return SystemCoreClock;
+#else
+    return 1000;
+#endif
+}
+
+HAL_StatusTypeDef I3G4250D_WriteRegisters(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress, const uint8_t *values, uint8_t count)
+{
+    uint8_t first = count;
+    uint8_t last = 0;
+    HAL_StatusTypeDef status;
+
+    // Find the shortest span of registers that differ from the cache, uncached and stale registers always count as changed
+    for (uint8_t i = 0; i < count; i++)
+    {
+        int8_t index = I3G4250D_ShadowIndex((uint8_t)(registerAddress + i));
+        if (index < 0 || (gyro->shadowStale & (1U << index)) || gyro->shadow[index] != values[i])
+        {
+            if (first == count)
+            {
+                first = i;
+            }
+            last = i;
+        }
+    }
+    if (first == count)
+    {
+        return HAL_OK;
+    }
+
+    status = I3G4250D_PushRegisters(gyro, (uint8_t)(registerAddress + first), &values[first], (uint8_t)(last - first + 1));
+    if (status == HAL_OK)
+    {
+        for (uint8_t i = first; i <= last; i++)
+        {
+            int8_t index = I3G4250D_ShadowIndex((uint8_t)(registerAddress + i));
+            if (index >= 0)
+            {
+                gyro->shadow[index] = values[i];
+            }
+        }
+        I3G4250D_UpdateTiming(gyro);
+        I3G4250D_UpdateAxes(gyro);
+    }
+    return status;
+}
+
+HAL_StatusTypeDef I3G4250D_WriteRegister(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress, uint8_t value)
+{
+    return I3G4250D_WriteRegisters(gyro, registerAddress, &value, 1);
+}
+
+HAL_StatusTypeDef I3G4250D_ModifyRegister(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress, uint8_t mask, uint8_t value)
+{
+    uint8_t current = I3G4250D_GetShadowRegister(gyro, registerAddress);
+
+    return I3G4250D_WriteRegister(gyro, registerAddress, (uint8_t)((current & ~mask) | (value & mask)));
+}
 
-    switch (accelerometerInit->FULLSCALE_SELECTION)
+uint8_t I3G4250D_GetShadowRegister(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress)
+{
+    int8_t index = I3G4250D_ShadowIndex(registerAddress);
+
+    return index >= 0 ? gyro->shadow[index] : 0;
+}
+
+// Sensitivity that belongs to a full scale selection
+static void I3G4250D_SetSensitivity(I3G4250D_HandleTypeDef *gyro, uint8_t fullScale)
+{
+    switch (fullScale)
     {
     case I3G4250D_SCALE_245:
-        I3G4250D_Sensitivity = I3G4250D_SENSITIVTY_8_75;
+        gyro->Sensitivity = I3G4250D_SENSITIVTY_8_75;
         break;
 
     case I3G4250D_SCALE_500:
-        I3G4250D_Sensitivity = I3G4250D_SENSITIVTY_17_50;
+        gyro->Sensitivity = I3G4250D_SENSITIVTY_17_50;
         break;
 
     case I3G4250D_SCALE_2000:
-        I3G4250D_Sensitivity = I3G4250D_SENSITIVTY_70;
+        gyro->Sensitivity = I3G4250D_SENSITIVTY_70;
         break;
 
     case I3G4250D_SCALE_2000_2:
-        I3G4250D_Sensitivity = I3G4250D_SENSITIVTY_70;
+        gyro->Sensitivity = I3G4250D_SENSITIVTY_70;
+        break;
+
+    default:
+        gyro->Sensitivity = I3G4250D_SENSITIVTY_17_50;
         break;
     }
 
-    // Disable Chip select
-    _I3G4250D_CS_DISABLE;
+    I3G4250D_UpdateGain(gyro);
 }
 
-I3G4250D_DataRaw I3G4250D_GetRawData(void)
+HAL_StatusTypeDef I3G4250D_SetEnabledAxis(I3G4250D_HandleTypeDef *gyro, uint8_t enabledAxis)
 {
-    uint8_t spiBuffer[2];
-    I3G4250D_DataRaw tempRawData;
+    return I3G4250D_ModifyRegister(gyro, I3G4250D_CTRL_REG1, 0x0F, enabledAxis);
+}
+
+HAL_StatusTypeDef I3G4250D_SetODR(I3G4250D_HandleTypeDef *gyro, uint8_t odrBwPreset)
+{
+    return I3G4250D_ModifyRegister(gyro, I3G4250D_CTRL_REG1, 0xF0, odrBwPreset);
+}
 
-    //read X axis data
-    I3G4250D_ReadIO(I3G4250D_OUT_X_L_ADDR, spiBuffer, 2);
-    tempRawData.x = ((spiBuffer[1] << 8) + spiBuffer[0]);
+HAL_StatusTypeDef I3G4250D_SetFullScale(I3G4250D_HandleTypeDef *gyro, uint8_t fullScale)
+{
+    HAL_StatusTypeDef status = I3G4250D_ModifyRegister(gyro, I3G4250D_CTRL_REG4, 0x30, (uint8_t)(fullScale >> 2));
 
-    //read Y axis data
-    I3G4250D_ReadIO(I3G4250D_OUT_Y_L_ADDR, spiBuffer, 2);
-    tempRawData.x = ((spiBuffer[1] << 8) + spiBuffer[0]);
+    if (status == HAL_OK)
+    {
+        I3G4250D_SetSensitivity(gyro, fullScale);
+    }
+    return status;
+}
 
-    //read Z axis data
-    I3G4250D_ReadIO(I3G4250D_OUT_Z_L_ADDR, spiBuffer, 2);
-    tempRawData.x = ((spiBuffer[1] << 8) + spiBuffer[0]);
+HAL_StatusTypeDef I3G4250D_SetFifoMode(I3G4250D_HandleTypeDef *gyro, uint8_t fifoMode, uint8_t watermark)
+{
+    HAL_StatusTypeDef status;
+    uint8_t fifoEnable = (fifoMode != I3G4250D_FIFO_MODE_BYPASS) ? I3G4250D_CTRL_REG5_FIFO_EN : 0;
 
-    return tempRawData;
+    status = I3G4250D_WriteRegister(gyro, I3G4250D_FIFO_CTRL_REG, (uint8_t)((fifoMode & 0xE0) | (watermark & 0x1F)));
+    if (status == HAL_OK)
+    {
+        status = I3G4250D_ModifyRegister(gyro, I3G4250D_CTRL_REG5, I3G4250D_CTRL_REG5_FIFO_EN, fifoEnable);
+    }
+    if (status == HAL_OK)
+    {
+        gyro->fifoWatermark = watermark & 0x1F;
+        // The FIFO starts filling now, loss estimates count from here
+        gyro->fifoTimestamp = I3G4250D_GetTimestamp();
+    }
+    return status;
 }
 
-I3G4250D_DataScaled I3G4250D_GetScaledData(void)
+// Slot of `gyro` in the instance table, I3G4250D_MAX_INSTANCES when it is not registered
+static uint8_t I3G4250D_InstanceIndex(const I3G4250D_HandleTypeDef *gyro)
 {
-    I3G4250D_DataRaw tempRawData = I3G4250D_GetRawData();
+    uint8_t i;
 
-    // Scaling and return
-    // TODO: Check if these values are applicable to the I3G4250D
-    I3G4250D_DataScaled scaledData;
-    scaledData.x = (tempRawData.x * I3G4250D_Sensitivity * X_Scale) + 0.0f - X_Bias;
-    scaledData.y = (tempRawData.x * I3G4250D_Sensitivity * Y_Scale) + 0.0f - Y_Bias;
-    scaledData.z = (tempRawData.x * I3G4250D_Sensitivity * Z_Scale) + 0.0f - Z_Bias;
+    for (i = 0; i < I3G4250D_MAX_INSTANCES; i++)
+    {
+        if (I3G4250D_Instances[i] == gyro)
+        {
+            break;
+        }
+    }
+    return i;
+}
 
-    return scaledData;
+// Reset the handle and register it, the gyroscope itself is not accessed. HAL_ERROR when all I3G4250D_MAX_INSTANCES are taken
+static HAL_StatusTypeDef I3G4250D_InitHandle(I3G4250D_HandleTypeDef *gyro, SPI_HandleTypeDef *accelerometerSPI, GPIO_TypeDef *csPort, uint16_t csPin)
+{
+    uint8_t i;
+
+    memset(gyro, 0, sizeof(*gyro));
+    // Keep a reference, the HAL DMA callbacks are raised with the caller's handle
+    gyro->SPI_Handle = accelerometerSPI;
+    gyro->CS_Port = csPort;
+    gyro->CS_Pin = csPin;
+    gyro->X_Scale = 1.0f;
+    gyro->Y_Scale = 1.0f;
+    gyro->Z_Scale = 1.0f;
+
+    // Register the gyroscope for the SPI completion handlers, without a slot its DMA completions would be dropped.
+    // A handle initialized again keeps its slot.
+    i = I3G4250D_InstanceIndex(gyro);
+    if (i == I3G4250D_MAX_INSTANCES)
+    {
+        i = I3G4250D_InstanceIndex(NULL);
+    }
+    if (i == I3G4250D_MAX_INSTANCES)
+    {
+        gyro->initState = I3G4250D_INIT_ERROR_INSTANCE;
+        return HAL_ERROR;
+    }
+    I3G4250D_Instances[i] = gyro;
+
+    // Deselect the gyroscope before the first transfer
+    _I3G4250D_CS_DISABLE(gyro);
+
+    // The timestamp source also times the transactions counted by the instrumentation
+    I3G4250D_TimestampInit();
+    gyro->fifoTimestamp = I3G4250D_GetTimestamp();
+#ifdef I3G4250D_ENABLE_STATS
+    I3G4250D_ResetStats(gyro);
+#endif
+    return HAL_OK;
 }
 
-bool I3G4250D_DataReady(uint32_t msTimeOut)
+// Write the configuration of `accelerometerInit` to the gyroscope, returns the first failed transfer
+static HAL_StatusTypeDef I3G4250D_Configure(I3G4250D_HandleTypeDef *gyro, const I3G4250D_InitTypeDef *accelerometerInit)
 {
-    uint8_t Acc_status;
-    uint8_t startTick = HAL_GetTick();
-    do
+    uint8_t spiData[5] = {0};
+    HAL_StatusTypeDef status;
+
+    //** 1. Enable all axis on the gyroscope and set output datarate and bandwidth preset**//
+    spiData[0] |= (accelerometerInit->ENABLED_AXIS & 0x0F);
+    spiData[0] |= (accelerometerInit->ODR_BW_PRESET & 0xF0);
+
+    //** 2. Set the High Pass filter mode and High pass filter frequency cutoff **//
+    spiData[1] |= ((accelerometerInit->HPF_MODE << 4) & 0x30);
+    spiData[1] |= ((accelerometerInit->HPCF_MODE >> 4) & 0x0F);
+
+    //** 3. Route data ready or FIFO watermark to INT2 **//
+    gyro->drdyMode = accelerometerInit->DRDY_MODE & (I3G4250D_CTRL_REG3_I2_DRDY | I3G4250D_CTRL_REG3_I2_WTM);
+    gyro->fifoWatermark = accelerometerInit->FIFO_WATERMARK & 0x1F;
+    spiData[2] = gyro->drdyMode;
+
+    //** 4. Set 4-wire SPI, Full scale selection and self test mode
+    spiData[3] |= ((accelerometerInit->FULLSCALE_SELECTION >> 2) & 0x30);
+    // Set the self test mode to normal and the SPI mode to 4 wire.
+    spiData[3] |= (0x00 & 0x00);
+
+    //** 5. Enable the FIFO **//
+    if (accelerometerInit->FIFO_MODE != I3G4250D_FIFO_MODE_BYPASS)
     {
-        I3G4250D_ReadIO(I3G4250D_STATUS_ADDR, &Acc_status, 1);
-    } while ((Acc_status & 0x07)==0 && (HAL_GetTick() - startTick < msTimeOut));
-    
-    if(Acc_status & 0x07)
+        spiData[4] |= I3G4250D_CTRL_REG5_FIFO_EN;
+    }
+
+    // values of CTRL_REG1..CTRL_REG5 of the I3G4250D
+    memcpy(gyro->shadow, spiData, sizeof(spiData));
+
+    //** 6. Set the FIFO mode and watermark **//
+    spiData[0] = 0;
+    spiData[0] |= (accelerometerInit->FIFO_MODE & 0xE0);
+    spiData[0] |= (accelerometerInit->FIFO_WATERMARK & 0x1F);
+    gyro->shadow[I3G4250D_ShadowIndex(I3G4250D_FIFO_CTRL_REG)] = spiData[0];
+
+    //** 7. Disable the INT1 interrupt generators **//
+    gyro->shadow[I3G4250D_ShadowIndex(I3G4250D_INT1_CFG_REG)] = 0;
+
+    // CTRL_REG1..CTRL_REG5 in one auto-increment burst, then FIFO_CTRL_REG and INT1_CFG_REG
+    status = I3G4250D_PushShadow(gyro);
+    I3G4250D_UpdateTiming(gyro);
+    I3G4250D_UpdateAxes(gyro);
+    I3G4250D_SetSensitivity(gyro, accelerometerInit->FULLSCALE_SELECTION);
+    return status;
+}
+
+HAL_StatusTypeDef I3G4250D_Init(I3G4250D_HandleTypeDef *gyro, SPI_HandleTypeDef *accelerometerSPI, GPIO_TypeDef *csPort, uint16_t csPin, I3G4250D_InitTypeDef *accelerometerInit)
+{
+    if (I3G4250D_InitHandle(gyro, accelerometerSPI, csPort, csPin) != HAL_OK)
     {
-        return true;
+        return HAL_ERROR;
     }
-    return false;
+    if (I3G4250D_Configure(gyro, accelerometerInit) != HAL_OK)
+    {
+        gyro->initState = I3G4250D_INIT_ERROR_CONFIGURE;
+        return HAL_ERROR;
+    }
+    gyro->initState = I3G4250D_INIT_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef I3G4250D_DeInit(I3G4250D_HandleTypeDef *gyro)
+{
+    uint8_t i = I3G4250D_InstanceIndex(gyro);
+
+    // The completion handler still has to find the gyroscope of a transfer in progress
+    if (gyro->dmaBusy)
+    {
+        return HAL_BUSY;
+    }
+    if (i == I3G4250D_MAX_INSTANCES)
+    {
+        return HAL_ERROR;
+    }
+    I3G4250D_Instances[i] = NULL;
+    return HAL_OK;
+}
+
+void I3G4250D_InitStart(I3G4250D_HandleTypeDef *gyro, SPI_HandleTypeDef *accelerometerSPI, GPIO_TypeDef *csPort, uint16_t csPin, const I3G4250D_InitTypeDef *accelerometerInit)
+{
+    if (I3G4250D_InitHandle(gyro, accelerometerSPI, csPort, csPin) != HAL_OK)
+    {
+        return;
+    }
+    gyro->initConfig = *accelerometerInit;
+    gyro->initState = I3G4250D_INIT_PROBE;
+    gyro->initTick = I3G4250D_GET_TICK();
+}
+
+I3G4250D_InitStateTypeDef I3G4250D_InitStep(I3G4250D_HandleTypeDef *gyro)
+{
+    uint8_t status = 0;
+
+    switch (gyro->initState)
+    {
+    case I3G4250D_INIT_PROBE:
+        // A gyroscope that is still booting answers with garbage, keep asking until the timeout
+        if (I3G4250D_ReadIO(gyro, I3G4250D_WHO_AM_I_ADDR, &gyro->whoAmI, 1) == HAL_OK && gyro->whoAmI == I3G4250D_WHO_AM_I_VALUE)
+        {
+            gyro->initState = I3G4250D_INIT_CONFIGURE;
+            gyro->initTick = I3G4250D_GET_TICK();
+        }
+        else if (I3G4250D_GET_TICK() - gyro->initTick >= I3G4250D_INIT_PROBE_TIMEOUT)
+        {
+            gyro->initState = I3G4250D_INIT_ERROR_ID;
+        }
+        break;
+
+    case I3G4250D_INIT_CONFIGURE:
+        // A bus that is busy right now is retried on the next step, the stale registers are rewritten in full
+        if (I3G4250D_Configure(gyro, &gyro->initConfig) != HAL_OK)
+        {
+            if (I3G4250D_GET_TICK() - gyro->initTick >= I3G4250D_INIT_PROBE_TIMEOUT)
+            {
+                gyro->initState = I3G4250D_INIT_ERROR_CONFIGURE;
+            }
+            break;
+        }
+        gyro->initTick = I3G4250D_GET_TICK();
+        // Left in power down there is no sample to wait for
+        gyro->initState = (gyro->shadow[0] & I3G4250D_CTRL_REG1_PD) ? I3G4250D_INIT_TURN_ON : I3G4250D_INIT_READY;
+        break;
+
+    case I3G4250D_INIT_TURN_ON:
+        if (I3G4250D_ReadIO(gyro, I3G4250D_STATUS_ADDR, &status, 1) == HAL_OK && (status & gyro->axisMask))
+        {
+            I3G4250D_GetRawData(gyro);
+            // The discarded sample may have overrun while waiting, start the accounting afterwards
+            I3G4250D_ResetOverruns(gyro);
+            gyro->fifoTimestamp = I3G4250D_GetTimestamp();
+            gyro->initState = I3G4250D_INIT_READY;
+        }
+        else if (I3G4250D_GET_TICK() - gyro->initTick >= I3G4250D_INIT_TURN_ON_TIMEOUT)
+        {
+            gyro->initState = I3G4250D_INIT_ERROR_TURN_ON;
+        }
+        break;
+
+    default:
+        break;
+    }
+    return gyro->initState;
+}
+
+// SPI_BAUDRATEPRESCALER_ values, entry i divides the kernel clock by 2^(i + 1)
+static const uint32_t I3G4250D_SpiPrescalers[8] = {
+    SPI_BAUDRATEPRESCALER_2, SPI_BAUDRATEPRESCALER_4, SPI_BAUDRATEPRESCALER_8, SPI_BAUDRATEPRESCALER_16,
+    SPI_BAUDRATEPRESCALER_32, SPI_BAUDRATEPRESCALER_64, SPI_BAUDRATEPRESCALER_128, SPI_BAUDRATEPRESCALER_256,
+};
+
+// Clock of the APB bus the SPI peripheral sits on
+static uint32_t I3G4250D_SpiKernelClock(SPI_HandleTypeDef *hspi)
+{
+#ifdef SPI2
+    if (hspi->Instance == SPI2)
+    {
+        return HAL_RCC_GetPCLK1Freq();
+    }
+#endif
+#ifdef SPI3
+    if (hspi->Instance == SPI3)
+    {
+        return HAL_RCC_GetPCLK1Freq();
+    }
+#endif
+    (void)hspi;
+    return HAL_RCC_GetPCLK2Freq();
+}
+
+uint32_t I3G4250D_GetSpiClock(I3G4250D_HandleTypeDef *gyro)
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        if (gyro->SPI_Handle->Init.BaudRatePrescaler == I3G4250D_SpiPrescalers[i])
+        {
+            return I3G4250D_SpiKernelClock(gyro->SPI_Handle) >> (i + 1);
+        }
+    }
+    return 0;
+}
+
+// Rewrite the cached configuration and read it back together with WHO_AM_I, every round has to match
+static bool I3G4250D_VerifyBus(I3G4250D_HandleTypeDef *gyro, uint16_t iterations)
+{
+    // A write clocked too fast may have changed a register, restore it before judging the reads
+    if (I3G4250D_PushShadow(gyro) != HAL_OK)
+    {
+        return false;
+    }
+
+    for (uint16_t n = 0; n < iterations; n++)
+    {
+        uint8_t whoAmI = (uint8_t)~I3G4250D_WHO_AM_I_VALUE;
+        uint8_t control[5];
+        uint8_t fifo[3];
+
+        // Preset with the complement so a transfer that fails without clocking any data can not pass
+        for (uint8_t i = 0; i < 5; i++)
+        {
+            control[i] = (uint8_t)~gyro->shadow[i];
+        }
+        fifo[0] = (uint8_t)~gyro->shadow[5];
+        fifo[2] = (uint8_t)~gyro->shadow[6];
+
+        // FIFO_CTRL_REG..INT1_CFG_REG in one burst, FIFO_SRC_REG in between changes with every sample
+        if (I3G4250D_ReadIO(gyro, I3G4250D_WHO_AM_I_ADDR, &whoAmI, 1) != HAL_OK
+            || I3G4250D_ReadIO(gyro, I3G4250D_CTRL_REG1, control, 5) != HAL_OK
+            || I3G4250D_ReadIO(gyro, I3G4250D_FIFO_CTRL_REG, fifo, 3) != HAL_OK
+            || whoAmI != I3G4250D_WHO_AM_I_VALUE || memcmp(control, gyro->shadow, 5) != 0
+            || fifo[0] != gyro->shadow[5] || fifo[2] != gyro->shadow[6])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+HAL_StatusTypeDef I3G4250D_TuneSpiClock(I3G4250D_HandleTypeDef *gyro, uint32_t maxHz, uint16_t iterations)
+{
+    SPI_HandleTypeDef *hspi = gyro->SPI_Handle;
+    uint32_t savedPrescaler = hspi->Init.BaudRatePrescaler;
+    uint32_t kernelClock = I3G4250D_SpiKernelClock(hspi);
+    HAL_StatusTypeDef status;
+
+    if (gyro->dmaBusy)
+    {
+        return HAL_BUSY;
+    }
+    if (iterations == 0)
+    {
+        iterations = I3G4250D_SPI_TUNE_ITERATIONS;
+    }
+    // Other clients of the bus must not transfer at the clocks being tried
+    status = I3G4250D_BUS_LOCK(hspi);
+    if (status != HAL_OK)
+    {
+        _I3G4250D_STATS_STATUS(gyro, status);
+        return status;
+    }
+
+    //** 1. From the fastest allowed prescaler to the slowest, the first one that passes every round is kept **//
+    status = HAL_ERROR;
+    for (uint8_t i = 0; i < 8 && status != HAL_OK; i++)
+    {
+        if (maxHz != 0 && (kernelClock >> (i + 1)) > maxHz)
+        {
+            continue;
+        }
+        if (I3G4250D_BUS_SET_PRESCALER(hspi, I3G4250D_SpiPrescalers[i]) != HAL_OK)
+        {
+            break;
+        }
+        if (I3G4250D_VerifyBus(gyro, iterations))
+        {
+            status = HAL_OK;
+        }
+    }
+
+    //** 2. No reliable clock, go back to the caller's configuration **//
+    if (status != HAL_OK)
+    {
+        I3G4250D_BUS_SET_PRESCALER(hspi, savedPrescaler);
+        I3G4250D_PushShadow(gyro);
+    }
+    I3G4250D_BUS_UNLOCK(hspi);
+    return status;
+}
+
+// Account for samples overwritten before they were read. `status` holds STATUS_REG overrun bits,
+// `dataRead` is set when the output registers or the FIFO were read, which clears the overrun bits of the device.
+static void I3G4250D_CheckOverrun(I3G4250D_HandleTypeDef *gyro, uint8_t status, uint32_t timestamp, bool dataRead)
+{
+    uint8_t flags = status & I3G4250D_STATUS_OVERRUN & (uint8_t)~gyro->overrunReported;
+    bool fifo = I3G4250D_FifoEnabled(gyro);
+    uint32_t lost = 1;
+
+    gyro->overrunReported = dataRead ? 0 : (gyro->overrunReported | flags);
+    if (flags != 0)
+    {
+        // A full FIFO missed every sample beyond its size since the previous drain
+        if (fifo && gyro->samplePeriod != 0)
+        {
+            uint32_t produced = (timestamp - gyro->fifoTimestamp) / gyro->samplePeriod;
+            if (produced > I3G4250D_FIFO_SIZE)
+            {
+                lost = produced - I3G4250D_FIFO_SIZE;
+            }
+        }
+        // ZYXOR alone still means every axis lost a sample
+        if ((flags & (I3G4250D_STATUS_XOR | I3G4250D_STATUS_YOR | I3G4250D_STATUS_ZOR)) == 0)
+        {
+            flags |= I3G4250D_STATUS_XOR | I3G4250D_STATUS_YOR | I3G4250D_STATUS_ZOR;
+        }
+        gyro->overruns.x += (flags & I3G4250D_STATUS_XOR) ? lost : 0;
+        gyro->overruns.y += (flags & I3G4250D_STATUS_YOR) ? lost : 0;
+        gyro->overruns.z += (flags & I3G4250D_STATUS_ZOR) ? lost : 0;
+        gyro->overruns.events++;
+        if (gyro->overrunCallback != NULL)
+        {
+            gyro->overrunCallback(gyro, flags, lost);
+        }
+    }
+    if (dataRead && fifo)
+    {
+        gyro->fifoTimestamp = timestamp;
+    }
+}
+
+I3G4250D_DataRaw I3G4250D_GetRawData(I3G4250D_HandleTypeDef *gyro)
+{
+    uint8_t frame[I3G4250D_TEMP_BURST_SIZE] = {0};
+    uint8_t offset = gyro->axisFrameOffset;
+    uint8_t size = gyro->axisFrameSize;
+    I3G4250D_DataRaw tempRawData;
+
+    // FIFO slots are always read whole like in I3G4250D_StartDMA, the FIFO only advances after OUT_Z_H
+    if (I3G4250D_FifoEnabled(gyro))
+    {
+        offset = gyro->tempComp.enabled ? 0 : 1;
+        size = (uint8_t)(3 - offset + 6);
+    }
+
+    // Read STATUS_REG and the enabled axes in a single auto-increment transaction, the overrun bits come for one extra byte.
+    // The burst starts at `offset` so the data lands in the slots of the full OUT_TEMP + STATUS_REG + OUT_X_L..OUT_Z_H layout.
+    frame[offset] = (uint8_t)((I3G4250D_OUT_TEMP_ADDR + offset) | I3G4250D_SPI_READ | I3G4250D_SPI_AUTO_INCREMENT);
+    if (I3G4250D_TransferIO(gyro, &frame[offset], size) != HAL_OK)
+    {
+        tempRawData.x = 0;
+        tempRawData.y = 0;
+        tempRawData.z = 0;
+        return tempRawData;
+    }
+
+    // The axis data follows the address byte, OUT_TEMP and STATUS_REG
+    I3G4250D_DecodeSample(&frame[3], gyro->axisMask, &tempRawData);
+    I3G4250D_CheckOverrun(gyro, frame[2], I3G4250D_GetTimestamp(), true);
+    if (offset == 0)
+    {
+        I3G4250D_TempUpdate(gyro, frame[1]);
+    }
+    _I3G4250D_STATS_SAMPLES(gyro, 1);
+
+    return tempRawData;
+}
+
+I3G4250D_DataScaled I3G4250D_GetScaledData(I3G4250D_HandleTypeDef *gyro)
+{
+    I3G4250D_DataRaw tempRawData = I3G4250D_GetRawData(gyro);
+
+    return I3G4250D_ConvertScaled(gyro, &tempRawData);
 }
 
-void I3G4250D_X_Calibrate(float x_min, float x_max)
+I3G4250D_DataScaled I3G4250D_ConvertScaled(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *raw)
 {
-    X_Bias = (x_max + x_min) / 2.0f;
-    X_Scale = (2*1000) / (x_max - x_min);
+    // Scaling and return
+    // TODO: Check if these values are applicable to the I3G4250D
+    I3G4250D_DataScaled scaledData;
+    scaledData.x = (raw->x * gyro->X_Gain) - gyro->X_OffsetFloat;
+    scaledData.y = (raw->y * gyro->Y_Gain) - gyro->Y_OffsetFloat;
+    scaledData.z = (raw->z * gyro->Z_Gain) - gyro->Z_OffsetFloat;
+
+    return scaledData;
 }
 
-void I3G4250D_Y_Calibrate(float y_min, float y_max)
+I3G4250D_DataFixed I3G4250D_GetFixedData(I3G4250D_HandleTypeDef *gyro)
 {
-    Y_Bias = (y_max + y_min) / 2.0f;
-    Y_Scale = (2*1000) / (y_max - y_min);
+    I3G4250D_DataRaw tempRawData = I3G4250D_GetRawData(gyro);
+
+    return I3G4250D_ConvertFixed(gyro, &tempRawData);
 }
 
-void I3G4250D_Z_Calibrate(float z_min, float z_max)
+I3G4250D_DataFixed I3G4250D_ConvertFixed(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *raw)
 {
-    Z_Bias = (z_max + z_min) / 2.0f;
-    Z_Scale = (2*1000) / (z_max - z_min);
-}
\ No newline at end of file
+    // 16 x 32 bit products are kept in 64 bit, a single SMULL on the Cortex-M4
+    I3G4250D_DataFixed fixedData;
+    fixedData.x = (int32_t)(((int64_t)raw->x * gyro->X_GainQ16) >> 16) - gyro->X_Offset;
+    fixedData.y = (int32_t)(((int64_t)raw->y * gyro->Y_GainQ16) >> 16) - gyro->Y_Offset;
+    fixedData.z = (int32_t)(((int64_t)raw->z * gyro->Z_GainQ16) >> 16) - gyro->Z_Offset;
+
+    return fixedData;
+}
+
+// Saturate to the int16 / q15 range
+static int16_t I3G4250D_SatQ15(int32_t value)
+{
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+}
+
+// Round a float to the nearest integer after multiplying it by `one`
+static int32_t I3G4250D_ToFixed(float value, float one)
+{
+    value *= one;
+    return (int32_t)(value >= 0.0f ? value + 0.5f : value - 0.5f);
+}
+
+void I3G4250D_UpdateGain(I3G4250D_HandleTypeDef *gyro)
+{
+    gyro->X_Gain = gyro->Sensitivity * gyro->X_Scale;
+    gyro->Y_Gain = gyro->Sensitivity * gyro->Y_Scale;
+    gyro->Z_Gain = gyro->Sensitivity * gyro->Z_Scale;
+
+    gyro->X_GainQ16 = I3G4250D_ToFixed(gyro->X_Gain, 65536.0f);
+    gyro->Y_GainQ16 = I3G4250D_ToFixed(gyro->Y_Gain, 65536.0f);
+    gyro->Z_GainQ16 = I3G4250D_ToFixed(gyro->Z_Gain, 65536.0f);
+
+    gyro->X_Offset = I3G4250D_ToFixed(gyro->X_Bias, 1.0f);
+    gyro->Y_Offset = I3G4250D_ToFixed(gyro->Y_Bias, 1.0f);
+    gyro->Z_Offset = I3G4250D_ToFixed(gyro->Z_Bias, 1.0f);
+    gyro->X_OffsetFloat = gyro->X_Bias;
+    gyro->Y_OffsetFloat = gyro->Y_Bias;
+    gyro->Z_OffsetFloat = gyro->Z_Bias;
+
+    // q15 scale with one shift for all axes, chosen so the largest scale still fits in a q15 fraction
+    float maxScale = gyro->X_Scale;
+    if (gyro->Y_Scale > maxScale)
+    {
+        maxScale = gyro->Y_Scale;
+    }
+    if (gyro->Z_Scale > maxScale)
+    {
+        maxScale = gyro->Z_Scale;
+    }
+    gyro->GainShiftQ15 = 0;
+    while (maxScale >= (float)(1 << gyro->GainShiftQ15) && gyro->GainShiftQ15 < 15)
+    {
+        gyro->GainShiftQ15++;
+    }
+    float one = 32768.0f / (float)(1 << gyro->GainShiftQ15);
+    gyro->X_GainQ15 = I3G4250D_SatQ15(I3G4250D_ToFixed(gyro->X_Scale, one));
+    gyro->Y_GainQ15 = I3G4250D_SatQ15(I3G4250D_ToFixed(gyro->Y_Scale, one));
+    gyro->Z_GainQ15 = I3G4250D_SatQ15(I3G4250D_ToFixed(gyro->Z_Scale, one));
+
+    gyro->X_OffsetQ15 = I3G4250D_SatQ15(I3G4250D_ToFixed(gyro->X_Bias / gyro->Sensitivity, 1.0f));
+    gyro->Y_OffsetQ15 = I3G4250D_SatQ15(I3G4250D_ToFixed(gyro->Y_Bias / gyro->Sensitivity, 1.0f));
+    gyro->Z_OffsetQ15 = I3G4250D_SatQ15(I3G4250D_ToFixed(gyro->Z_Bias / gyro->Sensitivity, 1.0f));
+
+    // The adaptive ODR threshold is compared against raw digits
+    if (gyro->Sensitivity > 0.0f)
+    {
+        gyro->adaptiveOdr.thresholdDigits = I3G4250D_ToFixed((float)gyro->adaptiveOdr.thresholdMdps / gyro->Sensitivity, 1.0f);
+    }
+
+    // Disabled axes scale to 0 in every conversion path without a per-sample check
+    if ((gyro->axisMask & 0x01) == 0)
+    {
+        gyro->X_Gain = 0.0f;
+        gyro->X_GainQ16 = 0;
+        gyro->X_Offset = 0;
+        gyro->X_OffsetFloat = 0.0f;
+        gyro->X_GainQ15 = 0;
+        gyro->X_OffsetQ15 = 0;
+    }
+    if ((gyro->axisMask & 0x02) == 0)
+    {
+        gyro->Y_Gain = 0.0f;
+        gyro->Y_GainQ16 = 0;
+        gyro->Y_Offset = 0;
+        gyro->Y_OffsetFloat = 0.0f;
+        gyro->Y_GainQ15 = 0;
+        gyro->Y_OffsetQ15 = 0;
+    }
+    if ((gyro->axisMask & 0x04) == 0)
+    {
+        gyro->Z_Gain = 0.0f;
+        gyro->Z_GainQ16 = 0;
+        gyro->Z_Offset = 0;
+        gyro->Z_OffsetFloat = 0.0f;
+        gyro->Z_GainQ15 = 0;
+        gyro->Z_OffsetQ15 = 0;
+    }
+}
+
+uint8_t I3G4250D_GetRawAxes(I3G4250D_HandleTypeDef *gyro, int16_t *out)
+{
+    I3G4250D_DataRaw raw = I3G4250D_GetRawData(gyro);
+
+    return (uint8_t)I3G4250D_PackAxes(gyro, &raw, out, 1);
+}
+
+size_t I3G4250D_PackAxes(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *in, int16_t *out, size_t n)
+{
+    uint8_t axisMask = gyro->axisMask;
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (axisMask & 0x01)
+        {
+            out[count++] = in[i].x;
+        }
+        if (axisMask & 0x02)
+        {
+            out[count++] = in[i].y;
+        }
+        if (axisMask & 0x04)
+        {
+            out[count++] = in[i].z;
+        }
+    }
+    return count;
+}
+
+void I3G4250D_ScaleBlock(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *in, I3G4250D_DataScaled *out, size_t n)
+{
+    float xGain = gyro->X_Gain, yGain = gyro->Y_Gain, zGain = gyro->Z_Gain;
+    float xBias = gyro->X_OffsetFloat, yBias = gyro->Y_OffsetFloat, zBias = gyro->Z_OffsetFloat;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i].x = (in[i].x * xGain) - xBias;
+        out[i].y = (in[i].y * yGain) - yBias;
+        out[i].z = (in[i].z * zGain) - zBias;
+    }
+}
+
+void I3G4250D_ScaleBlockFixed(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *in, I3G4250D_DataFixed *out, size_t n)
+{
+    int32_t xGain = gyro->X_GainQ16, yGain = gyro->Y_GainQ16, zGain = gyro->Z_GainQ16;
+    int32_t xOffset = gyro->X_Offset, yOffset = gyro->Y_Offset, zOffset = gyro->Z_Offset;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        out[i].x = (int32_t)(((int64_t)in[i].x * xGain) >> 16) - xOffset;
+        out[i].y = (int32_t)(((int64_t)in[i].y * yGain) >> 16) - yOffset;
+        out[i].z = (int32_t)(((int64_t)in[i].z * zGain) >> 16) - zOffset;
+    }
+}
+
+// Scale one q15 value, saturating both the product and the offset subtraction like __QSUB16 does
+static int16_t I3G4250D_ScaleQ15(int16_t value, int16_t gain, uint8_t rightShift, int16_t offset)
+{
+    int32_t scaled = I3G4250D_SatQ15(((int32_t)value * gain) >> rightShift);
+    return I3G4250D_SatQ15(scaled - offset);
+}
+
+void I3G4250D_ScaleBlockQ15(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *in, I3G4250D_DataRaw *out, size_t n)
+{
+    uint8_t rightShift = 15 - gyro->GainShiftQ15;
+    size_t i = 0;
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    // Two samples are three 32 bit words with the axes interleaved as [x0 y0] [z0 x1] [y1 z1],
+    // so the gains and offsets are packed in the same order and each word is processed as two lanes.
+    // arm_scale_q15/arm_offset_q15 cannot be used because they apply a single scale to the whole array.
+    _Static_assert(sizeof(I3G4250D_DataRaw) == 6, "I3G4250D_DataRaw must be three packed int16");
+    uint32_t gains[3], offsets[3];
+    gains[0] = __PKHBT((uint16_t)gyro->X_GainQ15, gyro->Y_GainQ15, 16);
+    gains[1] = __PKHBT((uint16_t)gyro->Z_GainQ15, gyro->X_GainQ15, 16);
+    gains[2] = __PKHBT((uint16_t)gyro->Y_GainQ15, gyro->Z_GainQ15, 16);
+    offsets[0] = __PKHBT((uint16_t)gyro->X_OffsetQ15, gyro->Y_OffsetQ15, 16);
+    offsets[1] = __PKHBT((uint16_t)gyro->Z_OffsetQ15, gyro->X_OffsetQ15, 16);
+    offsets[2] = __PKHBT((uint16_t)gyro->Y_OffsetQ15, gyro->Z_OffsetQ15, 16);
+
+    for (; i + 1 < n; i += 2)
+    {
+        uint32_t words[3];
+        // The samples are only 2 byte aligned, memcpy compiles to unaligned LDR/STR
+        memcpy(words, &in[i], sizeof(words));
+        for (uint8_t w = 0; w < 3; w++)
+        {
+            int32_t low = __SSAT((int32_t)__SMULBB(words[w], gains[w]) >> rightShift, 16);
+            int32_t high = __SSAT((int32_t)__SMULTT(words[w], gains[w]) >> rightShift, 16);
+            words[w] = __QSUB16(__PKHBT((uint32_t)low, (uint32_t)high, 16), offsets[w]);
+        }
+        memcpy(&out[i], words, sizeof(words));
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        out[i].x = I3G4250D_ScaleQ15(in[i].x, gyro->X_GainQ15, rightShift, gyro->X_OffsetQ15);
+        out[i].y = I3G4250D_ScaleQ15(in[i].y, gyro->Y_GainQ15, rightShift, gyro->Y_OffsetQ15);
+        out[i].z = I3G4250D_ScaleQ15(in[i].z, gyro->Z_GainQ15, rightShift, gyro->Z_OffsetQ15);
+    }
+}
+
+bool I3G4250D_DataReady(I3G4250D_HandleTypeDef *gyro, uint32_t msTimeOut)
+{
+    uint8_t Acc_status = 0;
+    uint32_t startTick = I3G4250D_GET_TICK();
+
+    // Interrupt driven, wait for the INT2 edge without polling the bus
+    if (gyro->drdyMode != I3G4250D_DRDY_POLLING)
+    {
+        while (!gyro->drdyFlag && (I3G4250D_GET_TICK() - startTick < msTimeOut))
+        {
+            I3G4250D_YIELD();
+        }
+        if (gyro->drdyFlag)
+        {
+            gyro->drdyFlag = false;
+            return true;
+        }
+        return false;
+    }
+
+    do
+    {
+        // A read that did not happen, e.g. the bus was taken, does not count as data
+        if (I3G4250D_ReadIO(gyro, I3G4250D_STATUS_ADDR, &Acc_status, 1) != HAL_OK)
+        {
+            Acc_status = 0;
+        }
+        _I3G4250D_STATS_POLL(gyro);
+        I3G4250D_YIELD();
+    } while ((Acc_status & 0x07)==0 && (I3G4250D_GET_TICK() - startTick < msTimeOut));
+
+    // Falling behind shows up here first, the data read that follows will not count it again
+    I3G4250D_CheckOverrun(gyro, Acc_status, I3G4250D_GetTimestamp(), false);
+
+    if(Acc_status & 0x07)
+    {
+        return true;
+    }
+    return false;
+}
+
+// Number of samples currently stored in the FIFO
+static size_t I3G4250D_FifoLevel(I3G4250D_HandleTypeDef *gyro)
+{
+    uint8_t fifoStatus = 0;
+
+    if (I3G4250D_ReadIO(gyro, I3G4250D_FIFO_SRC_REG, &fifoStatus, 1) != HAL_OK || (fifoStatus & I3G4250D_FIFO_SRC_EMPTY))
+    {
+        return 0;
+    }
+    if (fifoStatus & I3G4250D_FIFO_SRC_OVRN)
+    {
+        I3G4250D_CheckOverrun(gyro, I3G4250D_STATUS_OVERRUN, I3G4250D_GetTimestamp(), false);
+        return I3G4250D_FIFO_SIZE;
+    }
+    return fifoStatus & I3G4250D_FIFO_SRC_FSS;
+}
+
+// Timestamp of the newest sample drained when `samples` of the `level` stored ones are read, the FIFO hands out the oldest first
+static uint32_t I3G4250D_DrainTimestamp(I3G4250D_HandleTypeDef *gyro, size_t level, size_t samples)
+{
+    return I3G4250D_GetTimestamp() - ((uint32_t)(level - samples) * gyro->samplePeriod);
+}
+
+// Drain up to `max` samples, `newestTimestamp` receives the timestamp of the last one
+static size_t I3G4250D_DrainFifo(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataRaw *out, size_t max, uint32_t *newestTimestamp)
+{
+    size_t level = I3G4250D_FifoLevel(gyro);
+    size_t samples = level;
+    uint8_t offset;
+
+    if (samples > max)
+    {
+        samples = max;
+    }
+    if (samples == 0)
+    {
+        return 0;
+    }
+    *newestTimestamp = I3G4250D_DrainTimestamp(gyro, level, samples);
+
+    // With the FIFO enabled the address wraps from OUT_Z_H back to OUT_X_L,
+    // so all stored samples can be drained in a single auto-increment burst, after OUT_TEMP with temperature compensation
+    offset = gyro->tempComp.enabled ? 0 : 2;
+    gyro->burstFrame[offset] = (uint8_t)((I3G4250D_OUT_TEMP_ADDR + offset) | I3G4250D_SPI_READ | I3G4250D_SPI_AUTO_INCREMENT);
+    if (I3G4250D_TransferIO(gyro, &gyro->burstFrame[offset], (uint16_t)(3 - offset + (samples * 6))) != HAL_OK)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < samples; i++)
+    {
+        I3G4250D_DecodeSample(&gyro->burstFrame[3 + (i * 6)], gyro->axisMask, &out[i]);
+    }
+    I3G4250D_CheckOverrun(gyro, 0, I3G4250D_GetTimestamp(), true);
+    if (offset == 0)
+    {
+        I3G4250D_TempUpdate(gyro, gyro->burstFrame[1]);
+    }
+    _I3G4250D_STATS_SAMPLES(gyro, samples);
+
+    return samples;
+}
+
+size_t I3G4250D_ReadFifo(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataRaw *out, size_t max)
+{
+    uint32_t newestTimestamp;
+
+    return I3G4250D_DrainFifo(gyro, out, max, &newestTimestamp);
+}
+
+void I3G4250D_RegisterOverrunCallback(I3G4250D_HandleTypeDef *gyro, I3G4250D_OverrunCallback callback)
+{
+    gyro->overrunCallback = callback;
+}
+
+void I3G4250D_GetOverruns(I3G4250D_HandleTypeDef *gyro, I3G4250D_OverrunTypeDef *overruns)
+{
+    memcpy(overruns, &gyro->overruns, sizeof(*overruns));
+}
+
+void I3G4250D_ResetOverruns(I3G4250D_HandleTypeDef *gyro)
+{
+    memset(&gyro->overruns, 0, sizeof(gyro->overruns));
+}
+
+// Timestamp of sample `index` in a block of `count` samples, reconstructed back from the newest sample
+static uint32_t I3G4250D_SampleTimestamp(I3G4250D_HandleTypeDef *gyro, uint32_t newestTimestamp, size_t index, size_t count)
+{
+    return newestTimestamp - ((uint32_t)(count - 1 - index) * gyro->samplePeriod);
+}
+
+I3G4250D_DataStamped I3G4250D_GetStampedData(I3G4250D_HandleTypeDef *gyro)
+{
+    I3G4250D_DataStamped stampedData;
+
+    // In interrupt mode the edge marks when the sample was taken, otherwise the read does
+    stampedData.timestamp = (gyro->drdyMode != I3G4250D_DRDY_POLLING) ? gyro->drdyTimestamp : I3G4250D_GetTimestamp();
+    stampedData.data = I3G4250D_GetRawData(gyro);
+
+    return stampedData;
+}
+
+size_t I3G4250D_ReadFifoStamped(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataStamped *out, size_t max)
+{
+    uint32_t newestTimestamp;
+    size_t samples;
+
+    if (max > I3G4250D_FIFO_SIZE)
+    {
+        max = I3G4250D_FIFO_SIZE;
+    }
+    samples = I3G4250D_DrainFifo(gyro, gyro->dmaSamples, max, &newestTimestamp);
+    for (size_t i = 0; i < samples; i++)
+    {
+        out[i].data = gyro->dmaSamples[i];
+        out[i].timestamp = I3G4250D_SampleTimestamp(gyro, newestTimestamp, i, samples);
+    }
+
+    return samples;
+}
+
+// Producer side of the ring buffer, only called from the completion interrupt
+// Samples are `period` timestamp ticks apart, the newest was taken at `newestTimestamp`
+static void I3G4250D_RingPush(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *samples, size_t count, uint32_t newestTimestamp, uint32_t period)
+{
+    I3G4250D_RingTypeDef *ring = &gyro->ring;
+    uint32_t head = ring->head;
+    uint32_t space = I3G4250D_RING_SIZE - (head - ring->tail);
+    size_t total = count;
+
+    if (count > space)
+    {
+        ring->overflows += (uint32_t)(count - space);
+        count = space;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        ring->samples[(head + i) & (I3G4250D_RING_SIZE - 1)] = samples[i];
+        ring->timestamps[(head + i) & (I3G4250D_RING_SIZE - 1)] = newestTimestamp - ((uint32_t)(total - 1 - i) * period);
+    }
+    // Samples must be written before the consumer can see the new head
+    __DMB();
+    ring->head = head + (uint32_t)count;
+}
+
+bool I3G4250D_RingPop(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataRaw *sample)
+{
+    return I3G4250D_RingPopBlock(gyro, sample, 1) == 1;
+}
+
+size_t I3G4250D_RingPopBlock(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataRaw *out, size_t max)
+{
+    I3G4250D_RingTypeDef *ring = &gyro->ring;
+    uint32_t tail = ring->tail;
+    size_t count = ring->head - tail;
+
+    if (count > max)
+    {
+        count = max;
+    }
+    // Read the head before the samples it publishes
+    __DMB();
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = ring->samples[(tail + i) & (I3G4250D_RING_SIZE - 1)];
+    }
+    // Samples must be copied out before the producer can reuse their slots
+    __DMB();
+    ring->tail = tail + (uint32_t)count;
+
+    return count;
+}
+
+size_t I3G4250D_RingCount(I3G4250D_HandleTypeDef *gyro)
+{
+    return gyro->ring.head - gyro->ring.tail;
+}
+
+uint32_t I3G4250D_RingOverflows(I3G4250D_HandleTypeDef *gyro)
+{
+    return gyro->ring.overflows;
+}
+
+bool I3G4250D_RingPopStamped(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataStamped *sample)
+{
+    return I3G4250D_RingPopBlockStamped(gyro, sample, 1) == 1;
+}
+
+size_t I3G4250D_RingPopBlockStamped(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataStamped *out, size_t max)
+{
+    I3G4250D_RingTypeDef *ring = &gyro->ring;
+    uint32_t tail = ring->tail;
+    size_t count = ring->head - tail;
+
+    if (count > max)
+    {
+        count = max;
+    }
+    // Read the head before the samples it publishes
+    __DMB();
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i].data = ring->samples[(tail + i) & (I3G4250D_RING_SIZE - 1)];
+        out[i].timestamp = ring->timestamps[(tail + i) & (I3G4250D_RING_SIZE - 1)];
+    }
+    // Samples must be copied out before the producer can reuse their slots
+    __DMB();
+    ring->tail = tail + (uint32_t)count;
+
+    return count;
+}
+
+// De-interleave `count` samples into the block being filled, the newest was taken at `newestTimestamp`
+static void I3G4250D_BlockPush(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *samples, size_t count, uint32_t newestTimestamp)
+{
+    I3G4250D_BlockCaptureTypeDef *capture = &gyro->blockCapture;
+    uint8_t rightShift = 15 - gyro->GainShiftQ15;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        I3G4250D_BlockTypeDef *block = &capture->blocks[capture->active];
+
+        if (capture->full[capture->active])
+        {
+            capture->dropped += (uint32_t)(count - i);
+            return;
+        }
+        if (capture->fill == 0)
+        {
+            block->timestamp = I3G4250D_SampleTimestamp(gyro, newestTimestamp, i, count);
+        }
+        if (capture->scaled)
+        {
+            block->x[capture->fill] = I3G4250D_ScaleQ15(samples[i].x, gyro->X_GainQ15, rightShift, gyro->X_OffsetQ15);
+            block->y[capture->fill] = I3G4250D_ScaleQ15(samples[i].y, gyro->Y_GainQ15, rightShift, gyro->Y_OffsetQ15);
+            block->z[capture->fill] = I3G4250D_ScaleQ15(samples[i].z, gyro->Z_GainQ15, rightShift, gyro->Z_OffsetQ15);
+        }
+        else
+        {
+            block->x[capture->fill] = samples[i].x;
+            block->y[capture->fill] = samples[i].y;
+            block->z[capture->fill] = samples[i].z;
+        }
+        if (++capture->fill == I3G4250D_BLOCK_SIZE)
+        {
+            block->sequence = capture->sequence++;
+            // The block must be complete before the consumer can see it
+            __DMB();
+            capture->full[capture->active] = true;
+            capture->active ^= 1;
+            capture->fill = 0;
+        }
+    }
+}
+
+void I3G4250D_BlockCaptureInit(I3G4250D_HandleTypeDef *gyro, I3G4250D_BlockTypeDef blocks[2], bool scaled)
+{
+    I3G4250D_BlockCaptureTypeDef *capture = &gyro->blockCapture;
+
+    capture->enabled = false;
+    __DMB();
+    capture->blocks = blocks;
+    capture->scaled = scaled;
+    capture->active = 0;
+    capture->read = 0;
+    capture->fill = 0;
+    capture->sequence = 0;
+    capture->full[0] = false;
+    capture->full[1] = false;
+    capture->dropped = 0;
+    __DMB();
+    capture->enabled = true;
+}
+
+void I3G4250D_BlockCaptureDisable(I3G4250D_HandleTypeDef *gyro)
+{
+    gyro->blockCapture.enabled = false;
+}
+
+I3G4250D_BlockTypeDef *I3G4250D_BlockGet(I3G4250D_HandleTypeDef *gyro)
+{
+    I3G4250D_BlockCaptureTypeDef *capture = &gyro->blockCapture;
+
+    if (capture->blocks == NULL || !capture->full[capture->read])
+    {
+        return NULL;
+    }
+    // Read the block only after seeing it full
+    __DMB();
+    return &capture->blocks[capture->read];
+}
+
+void I3G4250D_BlockRelease(I3G4250D_HandleTypeDef *gyro)
+{
+    I3G4250D_BlockCaptureTypeDef *capture = &gyro->blockCapture;
+
+    if (capture->blocks == NULL || !capture->full[capture->read])
+    {
+        return;
+    }
+    // Done with the block before the producer may overwrite it
+    __DMB();
+    capture->full[capture->read] = false;
+    capture->read ^= 1;
+}
+
+uint32_t I3G4250D_BlockDropped(I3G4250D_HandleTypeDef *gyro)
+{
+    return gyro->blockCapture.dropped;
+}
+
+void I3G4250D_RegisterCallback(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataCallback callback)
+{
+    gyro->dataCallback = callback;
+}
+
+// Start a DMA burst of `samples` samples starting at OUT_X_L, the newest of which was taken at `newestTimestamp`
+static HAL_StatusTypeDef I3G4250D_StartDMA(I3G4250D_HandleTypeDef *gyro, size_t samples, uint32_t newestTimestamp)
+{
+    HAL_StatusTypeDef status;
+    uint8_t offset = gyro->tempComp.enabled ? 0 : 1;
+    uint16_t size = (uint16_t)(3 - offset + (samples * 6));
+
+    gyro->dmaBusy = true;
+    gyro->dmaSampleCount = samples;
+    gyro->blockTimestamp = newestTimestamp;
+    // A single sample from the output registers only needs the enabled axes, like I3G4250D_GetRawData.
+    // FIFO slots are always read whole, the FIFO only advances after OUT_Z_H.
+    if (samples == 1 && !I3G4250D_FifoEnabled(gyro))
+    {
+        offset = gyro->axisFrameOffset;
+        size = gyro->axisFrameSize;
+        gyro->burstFrame[2] = 0;
+    }
+    // Start at STATUS_REG for the overrun bits (or OUT_TEMP before it), the address then continues at OUT_X_L and wraps there while the FIFO is enabled
+    gyro->burstFrame[offset] = (uint8_t)((I3G4250D_OUT_TEMP_ADDR + offset) | I3G4250D_SPI_READ | I3G4250D_SPI_AUTO_INCREMENT);
+    _I3G4250D_CS_ENABLE(gyro);
+    // Transmitted and received in place like I3G4250D_TransferIO
+    status = I3G4250D_BUS_TRANSFER_DMA(gyro->SPI_Handle, &gyro->burstFrame[offset], &gyro->burstFrame[offset], size);
+    if (status != HAL_OK)
+    {
+        _I3G4250D_CS_DISABLE(gyro);
+        gyro->dmaBusy = false;
+        _I3G4250D_STATS_STATUS(gyro, status);
+    }
+    return status;
+}
+
+HAL_StatusTypeDef I3G4250D_GetRawDataDMA(I3G4250D_HandleTypeDef *gyro)
+{
+    if (gyro->dmaBusy)
+    {
+        return HAL_BUSY;
+    }
+    return I3G4250D_StartDMA(gyro, 1, I3G4250D_GetTimestamp());
+}
+
+HAL_StatusTypeDef I3G4250D_ReadFifoDMA(I3G4250D_HandleTypeDef *gyro, size_t max)
+{
+    size_t level;
+    size_t samples;
+
+    if (gyro->dmaBusy)
+    {
+        return HAL_BUSY;
+    }
+
+    // The FIFO level is read with a short blocking transfer, only the burst itself uses DMA
+    level = I3G4250D_FifoLevel(gyro);
+    samples = level;
+    if (samples > max)
+    {
+        samples = max;
+    }
+    if (samples == 0)
+    {
+        return HAL_ERROR;
+    }
+    return I3G4250D_StartDMA(gyro, samples, I3G4250D_DrainTimestamp(gyro, level, samples));
+}
+
+bool I3G4250D_DMABusy(I3G4250D_HandleTypeDef *gyro)
+{
+    return gyro->dmaBusy;
+}
+
+// Gyroscope with a DMA transfer in progress on the given SPI bus
+static I3G4250D_HandleTypeDef *I3G4250D_FindTransfer(SPI_HandleTypeDef *hspi)
+{
+    for (uint8_t i = 0; i < I3G4250D_MAX_INSTANCES; i++)
+    {
+        I3G4250D_HandleTypeDef *gyro = I3G4250D_Instances[i];
+        if (gyro != NULL && gyro->SPI_Handle == hspi && gyro->dmaBusy)
+        {
+            return gyro;
+        }
+    }
+    return NULL;
+}
+
+void I3G4250D_TxRxCpltHandler(SPI_HandleTypeDef *hspi)
+{
+    I3G4250D_HandleTypeDef *gyro = I3G4250D_FindTransfer(hspi);
+    const I3G4250D_DataRaw *delivered;
+    size_t deliveredCount;
+    uint32_t deliveredTimestamp;
+    uint32_t deliveredPeriod;
+
+    if (gyro == NULL)
+    {
+        I3G4250D_BUS_COMPLETE(hspi);
+        return;
+    }
+    _I3G4250D_CS_DISABLE(gyro);
+
+    for (size_t i = 0; i < gyro->dmaSampleCount; i++)
+    {
+        I3G4250D_DecodeSample(&gyro->burstFrame[3 + (i * 6)], gyro->axisMask, &gyro->dmaSamples[i]);
+    }
+    delivered = gyro->dmaSamples;
+    deliveredCount = gyro->dmaSampleCount;
+    deliveredTimestamp = gyro->blockTimestamp;
+    deliveredPeriod = gyro->samplePeriod;
+    gyro->dmaBusy = false;
+    I3G4250D_CheckOverrun(gyro, gyro->burstFrame[2], gyro->blockTimestamp, true);
+    _I3G4250D_STATS_SAMPLES(gyro, gyro->dmaSampleCount);
+    if (gyro->tempComp.enabled)
+    {
+        I3G4250D_TempUpdate(gyro, gyro->burstFrame[1]);
+    }
+
+    // The ring and the data callback get the decimated stream, every other stage the full rate
+    if (gyro->decimator.enabled)
+    {
+        size_t last = 0;
+        delivered = gyro->decimator.output;
+        deliveredCount = I3G4250D_Decimate(gyro, gyro->dmaSamples, gyro->dmaSampleCount, &last);
+        deliveredTimestamp = I3G4250D_SampleTimestamp(gyro, gyro->blockTimestamp, last, gyro->dmaSampleCount);
+        deliveredPeriod *= gyro->decimator.ratio;
+    }
+    I3G4250D_RingPush(gyro, delivered, deliveredCount, deliveredTimestamp, deliveredPeriod);
+    if (gyro->blockCapture.enabled)
+    {
+        I3G4250D_BlockPush(gyro, gyro->dmaSamples, gyro->dmaSampleCount, gyro->blockTimestamp);
+    }
+
+    if (gyro->biasEstimator.enabled)
+    {
+        I3G4250D_BiasEstimatorUpdate(gyro, gyro->dmaSamples, gyro->dmaSampleCount);
+    }
+
+    // Only decided here, the register write is a blocking transfer done by I3G4250D_AdaptiveOdrService
+    if (gyro->adaptiveOdr.enabled)
+    {
+        I3G4250D_AdaptiveOdrDecide(gyro, gyro->dmaSamples, gyro->dmaSampleCount);
+    }
+
+    if (gyro->dataCallback != NULL && deliveredCount > 0)
+    {
+        gyro->dataCallback(gyro, delivered, deliveredCount);
+    }
+
+    // An INT2 edge arrived while the bus was busy, fetch it now
+    if (gyro->irqPending)
+    {
+        gyro->irqPending = false;
+        I3G4250D_INT2_CaptureHandler(gyro, gyro->drdyTimestamp);
+    }
+    I3G4250D_BUS_COMPLETE(hspi);
+}
+
+void I3G4250D_ErrorHandler(SPI_HandleTypeDef *hspi)
+{
+    I3G4250D_HandleTypeDef *gyro = I3G4250D_FindTransfer(hspi);
+
+    if (gyro != NULL)
+    {
+        _I3G4250D_CS_DISABLE(gyro);
+        gyro->dmaBusy = false;
+        _I3G4250D_STATS_STATUS(gyro, HAL_ERROR);
+    }
+    I3G4250D_BUS_COMPLETE(hspi);
+}
+
+void I3G4250D_INT2_IRQHandler(I3G4250D_HandleTypeDef *gyro)
+{
+    I3G4250D_INT2_CaptureHandler(gyro, I3G4250D_GetTimestamp());
+}
+
+void I3G4250D_INT2_CaptureHandler(I3G4250D_HandleTypeDef *gyro, uint32_t timestamp)
+{
+    gyro->drdyFlag = true;
+    if (gyro->dmaBusy)
+    {
+        // Keep the first edge, the pending read is serviced from the completion handler
+        if (!gyro->irqPending)
+        {
+            gyro->drdyTimestamp = timestamp;
+        }
+        gyro->irqPending = true;
+        return;
+    }
+    gyro->drdyTimestamp = timestamp;
+
+    if (gyro->drdyMode == I3G4250D_DRDY_INT2)
+    {
+        I3G4250D_StartDMA(gyro, 1, timestamp);
+    }
+    else if (gyro->drdyMode == I3G4250D_DRDY_INT2_WTM)
+    {
+        // WTM is set once the FIFO holds at least the watermark level, so that many samples
+        // can be drained without reading FIFO_SRC_REG first
+        // The newest of those samples is the one that raised the edge
+        I3G4250D_StartDMA(gyro, gyro->fifoWatermark > 0 ? gyro->fifoWatermark : 1, timestamp);
+    }
+}
+
+#ifdef I3G4250D_USE_HAL_SPI_CALLBACKS
+// Route the HAL SPI callbacks to the driver, leave undefined if the application implements them itself
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    I3G4250D_TxRxCpltHandler(hspi);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    I3G4250D_ErrorHandler(hspi);
+}
+#endif
+
+void I3G4250D_X_Calibrate(I3G4250D_HandleTypeDef *gyro, float x_min, float x_max)
+{
+    gyro->X_Bias = (x_max + x_min) / 2.0f;
+    gyro->X_Scale = (2*1000) / (x_max - x_min);
+    I3G4250D_UpdateGain(gyro);
+}
+
+void I3G4250D_Y_Calibrate(I3G4250D_HandleTypeDef *gyro, float y_min, float y_max)
+{
+    gyro->Y_Bias = (y_max + y_min) / 2.0f;
+    gyro->Y_Scale = (2*1000) / (y_max - y_min);
+    I3G4250D_UpdateGain(gyro);
+}
+
+void I3G4250D_Z_Calibrate(I3G4250D_HandleTypeDef *gyro, float z_min, float z_max)
+{
+    gyro->Z_Bias = (z_max + z_min) / 2.0f;
+    gyro->Z_Scale = (2*1000) / (z_max - z_min);
+    I3G4250D_UpdateGain(gyro);
+}
+
+HAL_StatusTypeDef I3G4250D_AutoCalibrate(I3G4250D_HandleTypeDef *gyro, uint16_t n_samples)
+{
+    uint8_t savedShadow[I3G4250D_SHADOW_SIZE];
+    uint8_t savedWatermark = gyro->fifoWatermark;
+    int32_t sum[3] = {0, 0, 0};
+    uint32_t collected = 0;
+    uint32_t startTick;
+    uint32_t msTimeOut;
+    uint32_t blockTime;
+    HAL_StatusTypeDef status = HAL_OK;
+
+    if (gyro->dmaBusy)
+    {
+        return HAL_BUSY;
+    }
+    if (n_samples == 0)
+    {
+        return HAL_ERROR;
+    }
+    memcpy(savedShadow, gyro->shadow, sizeof(savedShadow));
+
+    //** 1. Ultra ODR on all axes, interrupts off and the FIFO restarted in stream mode **//
+    I3G4250D_WriteRegister(gyro, I3G4250D_CTRL_REG3, 0x00);
+    I3G4250D_ModifyRegister(gyro, I3G4250D_CTRL_REG1, 0xFF, I3G4250D_ODR_BW_ULTRA | I3G4250D_ENABLE_ALL_AXIS);
+    I3G4250D_SetFifoMode(gyro, I3G4250D_FIFO_MODE_BYPASS, 0);
+    I3G4250D_SetFifoMode(gyro, I3G4250D_FIFO_MODE_STREAM, 0);
+
+    // Time to fill the FIFO, and a generous limit for the whole run
+    blockTime = ((I3G4250D_FIFO_SIZE - 2) * 1000) / I3G4250D_GetODR(gyro);
+    msTimeOut = 100 + (2 * ((uint32_t)n_samples * 1000) / I3G4250D_GetODR(gyro));
+
+    //** 2. Drop the first block, the output settles after the ODR change **//
+    I3G4250D_DELAY(blockTime);
+    I3G4250D_ReadFifo(gyro, gyro->dmaSamples, I3G4250D_FIFO_SIZE);
+
+    //** 3. Average whole FIFO blocks **//
+    startTick = I3G4250D_GET_TICK();
+    while (collected < n_samples)
+    {
+        if (I3G4250D_GET_TICK() - startTick >= msTimeOut)
+        {
+            status = HAL_TIMEOUT;
+            break;
+        }
+        I3G4250D_DELAY(blockTime);
+
+        // Drain the whole FIFO every time, the samples beyond n_samples are dropped
+        size_t samples = I3G4250D_ReadFifo(gyro, gyro->dmaSamples, I3G4250D_FIFO_SIZE);
+        if (samples > n_samples - collected)
+        {
+            samples = n_samples - collected;
+        }
+        for (size_t i = 0; i < samples; i++)
+        {
+            sum[0] += gyro->dmaSamples[i].x;
+            sum[1] += gyro->dmaSamples[i].y;
+            sum[2] += gyro->dmaSamples[i].z;
+        }
+        collected += samples;
+    }
+
+    if (status == HAL_OK)
+    {
+        // Mean in Q24.8 digits, the bias itself is stored in MDPS
+        int32_t mean[3];
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            mean[axis] = (int32_t)(((int64_t)sum[axis] * 256) / (int32_t)collected);
+        }
+        gyro->X_Bias = (mean[0] * gyro->X_Gain) / 256.0f;
+        gyro->Y_Bias = (mean[1] * gyro->Y_Gain) / 256.0f;
+        gyro->Z_Bias = (mean[2] * gyro->Z_Gain) / 256.0f;
+        I3G4250D_UpdateGain(gyro);
+
+        // Give the online estimator a head start
+        memcpy(gyro->biasEstimator.bias, mean, sizeof(mean));
+        gyro->biasEstimator.biasValid = true;
+    }
+
+    //** 4. Restore the previous configuration, going through bypass mode empties the FIFO **//
+    I3G4250D_SetFifoMode(gyro, I3G4250D_FIFO_MODE_BYPASS, 0);
+    I3G4250D_WriteRegisters(gyro, I3G4250D_CTRL_REG1, savedShadow, 5);
+    I3G4250D_SetFifoMode(gyro, savedShadow[I3G4250D_ShadowIndex(I3G4250D_FIFO_CTRL_REG)] & 0xE0, savedWatermark);
+
+    return status;
+}
+
+void I3G4250D_BiasEstimatorInit(I3G4250D_HandleTypeDef *gyro, uint32_t varianceThreshold, uint16_t minStillSamples)
+{
+    I3G4250D_BiasEstimatorTypeDef *estimator = &gyro->biasEstimator;
+
+    memset(estimator, 0, sizeof(*estimator));
+    estimator->filterShift = 5;
+    estimator->biasShift = 2;
+    estimator->varianceThreshold = varianceThreshold;
+    estimator->minStillSamples = minStillSamples > 0 ? minStillSamples : 1;
+    estimator->enabled = true;
+}
+
+void I3G4250D_BiasEstimatorDisable(I3G4250D_HandleTypeDef *gyro)
+{
+    gyro->biasEstimator.enabled = false;
+}
+
+bool I3G4250D_IsStationary(I3G4250D_HandleTypeDef *gyro)
+{
+    return gyro->biasEstimator.stationary;
+}
+
+// Move the bias towards the stationary mean and apply it to the scaling
+static void I3G4250D_BiasEstimatorApply(I3G4250D_HandleTypeDef *gyro)
+{
+    I3G4250D_BiasEstimatorTypeDef *estimator = &gyro->biasEstimator;
+
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        if (estimator->biasValid)
+        {
+            estimator->bias[axis] += (estimator->mean[axis] - estimator->bias[axis]) >> estimator->biasShift;
+        }
+        else
+        {
+            estimator->bias[axis] = estimator->mean[axis];
+        }
+    }
+    estimator->biasValid = true;
+
+    // The bias is subtracted after scaling, so it is stored in MDPS
+    gyro->X_Bias = (estimator->bias[0] * gyro->X_Gain) / 256.0f;
+    gyro->Y_Bias = (estimator->bias[1] * gyro->Y_Gain) / 256.0f;
+    gyro->Z_Bias = (estimator->bias[2] * gyro->Z_Gain) / 256.0f;
+    I3G4250D_UpdateGain(gyro);
+}
+
+void I3G4250D_BiasEstimatorUpdate(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *samples, size_t n)
+{
+    I3G4250D_BiasEstimatorTypeDef *estimator = &gyro->biasEstimator;
+    uint8_t shift = estimator->filterShift;
+    // Q24.8 like the variance, thresholds beyond its 2047^2 digits^2 clamp count every sample as stationary
+    int32_t threshold = estimator->varianceThreshold < ((uint32_t)INT32_MAX >> 8) ? (int32_t)(estimator->varianceThreshold << 8) : INT32_MAX;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        int16_t axisData[3] = {samples[i].x, samples[i].y, samples[i].z};
+        bool still = true;
+
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            int32_t value = (int32_t)axisData[axis] << 8;
+            if (estimator->samples == 0)
+            {
+                estimator->mean[axis] = value;
+            }
+            int32_t delta = value - estimator->mean[axis];
+            estimator->mean[axis] += delta >> shift;
+
+            // Deviations this large are motion anyway, clamping keeps the square within 32 bits
+            int32_t deviation = delta / 256;
+            if (deviation > 2047)
+            {
+                deviation = 2047;
+            }
+            else if (deviation < -2047)
+            {
+                deviation = -2047;
+            }
+            estimator->variance[axis] += ((deviation * deviation * 256) - estimator->variance[axis]) >> shift;
+
+            if (estimator->variance[axis] > threshold)
+            {
+                still = false;
+            }
+        }
+
+        // Let the filters settle before trusting them
+        if (estimator->samples < (2U << shift))
+        {
+            estimator->samples++;
+            continue;
+        }
+
+        if (!still)
+        {
+            estimator->stillCount = 0;
+            estimator->stationary = false;
+            continue;
+        }
+        estimator->stillCount++;
+        if (estimator->stillCount >= estimator->minStillSamples)
+        {
+            estimator->stationary = true;
+            estimator->stillCount = 0;
+            I3G4250D_BiasEstimatorApply(gyro);
+        }
+    }
+}
+
+void I3G4250D_AdaptiveOdrInit(I3G4250D_HandleTypeDef *gyro, uint8_t lowPreset, uint8_t highPreset, uint32_t thresholdMdps, uint32_t quietMs)
+{
+    static const uint16_t odrHz[4] = {I3G4250D_ODR_HZ_DR_00, I3G4250D_ODR_HZ_DR_01, I3G4250D_ODR_HZ_DR_10, I3G4250D_ODR_HZ_DR_11};
+    I3G4250D_AdaptiveOdrTypeDef *adaptive = &gyro->adaptiveOdr;
+
+    memset(adaptive, 0, sizeof(*adaptive));
+    adaptive->lowPreset = lowPreset & 0xF0;
+    adaptive->highPreset = highPreset & 0xF0;
+    adaptive->thresholdMdps = thresholdMdps;
+    // The quiet period is only counted at the high rate, so it can be kept in samples
+    adaptive->quietSamples = (uint32_t)(((uint64_t)quietMs * odrHz[adaptive->highPreset >> 6]) / 1000);
+    adaptive->high = (gyro->shadow[0] & 0xF0) == adaptive->highPreset;
+    I3G4250D_UpdateGain(gyro);
+    adaptive->enabled = true;
+}
+
+void I3G4250D_AdaptiveOdrDisable(I3G4250D_HandleTypeDef *gyro)
+{
+    gyro->adaptiveOdr.enabled = false;
+    gyro->adaptiveOdr.pending = false;
+}
+
+// Look for motion in `n` samples and mark a switch as pending, returns true when one is pending
+static bool I3G4250D_AdaptiveOdrDecide(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *samples, size_t n)
+{
+    I3G4250D_AdaptiveOdrTypeDef *adaptive = &gyro->adaptiveOdr;
+    int32_t threshold = adaptive->thresholdDigits;
+    bool motion = false;
+    uint8_t preset;
+
+    if (adaptive->pending)
+    {
+        return true;
+    }
+    if (n == 0)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < n && !motion; i++)
+    {
+        // X_OffsetQ15.. hold the bias in digits
+        int32_t x = samples[i].x - gyro->X_OffsetQ15;
+        int32_t y = samples[i].y - gyro->Y_OffsetQ15;
+        int32_t z = samples[i].z - gyro->Z_OffsetQ15;
+        motion = x > threshold || -x > threshold || y > threshold || -y > threshold || z > threshold || -z > threshold;
+    }
+
+    if (motion)
+    {
+        adaptive->quietCount = 0;
+        if (adaptive->high)
+        {
+            return false;
+        }
+        preset = adaptive->highPreset;
+    }
+    else
+    {
+        if (!adaptive->high)
+        {
+            return false;
+        }
+        adaptive->quietCount += (uint32_t)n;
+        if (adaptive->quietCount < adaptive->quietSamples)
+        {
+            return false;
+        }
+        preset = adaptive->lowPreset;
+    }
+
+    adaptive->pendingPreset = preset;
+    adaptive->pending = true;
+    return true;
+}
+
+bool I3G4250D_AdaptiveOdrService(I3G4250D_HandleTypeDef *gyro)
+{
+    I3G4250D_AdaptiveOdrTypeDef *adaptive = &gyro->adaptiveOdr;
+
+    // The blocking write can not share the bus with a DMA read, the switch stays pending for the next call
+    if (!adaptive->enabled || !adaptive->pending || gyro->dmaBusy)
+    {
+        return false;
+    }
+    if (I3G4250D_ModifyRegister(gyro, I3G4250D_CTRL_REG1, 0xF0, adaptive->pendingPreset) != HAL_OK)
+    {
+        return false;
+    }
+    adaptive->high = !adaptive->high;
+    adaptive->quietCount = 0;
+    adaptive->switches++;
+    adaptive->pending = false;
+    return true;
+}
+
+bool I3G4250D_AdaptiveOdrUpdate(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *samples, size_t n)
+{
+    return I3G4250D_AdaptiveOdrDecide(gyro, samples, n) && I3G4250D_AdaptiveOdrService(gyro);
+}
+
+HAL_StatusTypeDef I3G4250D_DecimatorInit(I3G4250D_HandleTypeDef *gyro, uint8_t ratio, uint8_t order)
+{
+    I3G4250D_DecimatorTypeDef *decimator = &gyro->decimator;
+    uint32_t gain = 1;
+
+    if (ratio < 2 || ratio > I3G4250D_DECIMATOR_MAX_RATIO || order < 1 || order > I3G4250D_DECIMATOR_MAX_ORDER)
+    {
+        return HAL_ERROR;
+    }
+    for (uint8_t stage = 0; stage < order; stage++)
+    {
+        gain *= ratio;
+    }
+    // 16 bit samples and the growth of the integrators have to fit the 32 bit registers
+    if (gain > (1UL << 16))
+    {
+        return HAL_ERROR;
+    }
+
+    decimator->enabled = false;
+    memset(decimator, 0, sizeof(*decimator));
+    decimator->ratio = ratio;
+    decimator->order = order;
+    decimator->gain = gain;
+    decimator->enabled = true;
+    return HAL_OK;
+}
+
+void I3G4250D_DecimatorDisable(I3G4250D_HandleTypeDef *gyro)
+{
+    gyro->decimator.enabled = false;
+}
+
+uint32_t I3G4250D_DecimatorRate(I3G4250D_HandleTypeDef *gyro)
+{
+    uint32_t odr = I3G4250D_GetODR(gyro);
+
+    return gyro->decimator.enabled ? odr / gyro->decimator.ratio : odr;
+}
+
+// Run `n` samples through the CIC filter, the outputs go to decimator.output, `last` gets the input index of the newest output
+static size_t I3G4250D_Decimate(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *in, size_t n, size_t *last)
+{
+    I3G4250D_DecimatorTypeDef *decimator = &gyro->decimator;
+    int32_t half = (int32_t)(decimator->gain / 2);
+    size_t outputs = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const int16_t input[3] = {in[i].x, in[i].y, in[i].z};
+        int16_t output[3];
+
+        // Integrators at the input rate, unsigned so the wrap around is defined
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            uint32_t value = (uint32_t)(int32_t)input[axis];
+            for (uint8_t stage = 0; stage < decimator->order; stage++)
+            {
+                decimator->integrators[stage][axis] += value;
+                value = decimator->integrators[stage][axis];
+            }
+        }
+        if (++decimator->phase < decimator->ratio)
+        {
+            continue;
+        }
+        decimator->phase = 0;
+
+        // Combs at the output rate, then remove the DC gain of ratio^order with rounding
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            uint32_t value = decimator->integrators[decimator->order - 1][axis];
+            int32_t result;
+            for (uint8_t stage = 0; stage < decimator->order; stage++)
+            {
+                uint32_t difference = value - decimator->combs[stage][axis];
+                decimator->combs[stage][axis] = value;
+                value = difference;
+            }
+            result = (int32_t)value;
+            result = (result >= 0 ? result + half : result - half) / (int32_t)decimator->gain;
+            output[axis] = (int16_t)(result > INT16_MAX ? INT16_MAX : (result < INT16_MIN ? INT16_MIN : result));
+        }
+        decimator->output[outputs].x = output[0];
+        decimator->output[outputs].y = output[1];
+        decimator->output[outputs].z = output[2];
+        outputs++;
+        *last = i;
+    }
+    return outputs;
+}
+
+// Zero rate level at `temperature`, linear between the neighbouring table entries and constant beyond both ends
+static void I3G4250D_TempInterpolate(const I3G4250D_TempCompTypeDef *tempComp, int8_t temperature, int32_t bias[3])
+{
+    const I3G4250D_TempBiasTypeDef *table = tempComp->table;
+    const I3G4250D_TempBiasTypeDef *low = &table[0];
+    const I3G4250D_TempBiasTypeDef *high;
+    int32_t span;
+    int32_t position;
+
+    for (uint8_t i = 1; i < tempComp->points && table[i].temperature <= temperature; i++)
+    {
+        low = &table[i];
+    }
+    high = (low + 1 < &table[tempComp->points]) ? low + 1 : low;
+    span = high->temperature - low->temperature;
+    position = temperature - low->temperature;
+    if (span <= 0 || position <= 0)
+    {
+        bias[0] = low->x;
+        bias[1] = low->y;
+        bias[2] = low->z;
+        return;
+    }
+    bias[0] = low->x + ((high->x - low->x) * position) / span;
+    bias[1] = low->y + ((high->y - low->y) * position) / span;
+    bias[2] = low->z + ((high->z - low->z) * position) / span;
+}
+
+// New OUT_TEMP reading, moves the bias along the table when the temperature changed
+static void I3G4250D_TempUpdate(I3G4250D_HandleTypeDef *gyro, uint8_t raw)
+{
+    I3G4250D_TempCompTypeDef *tempComp = &gyro->tempComp;
+    int32_t temperature = I3G4250D_TEMP_OFFSET - (int8_t)raw;
+    int32_t bias[3];
+
+    temperature = temperature > INT8_MAX ? INT8_MAX : (temperature < INT8_MIN ? INT8_MIN : temperature);
+    tempComp->raw = raw;
+    if (tempComp->valid && tempComp->temperature == (int8_t)temperature)
+    {
+        return;
+    }
+    tempComp->temperature = (int8_t)temperature;
+    tempComp->valid = true;
+    if (!tempComp->enabled || tempComp->table == NULL)
+    {
+        return;
+    }
+
+    // Only the difference is applied, a calibrated bias stays in place and follows the slope of the table
+    I3G4250D_TempInterpolate(tempComp, tempComp->temperature, bias);
+    gyro->X_Bias += (float)(bias[0] - tempComp->applied[0]);
+    gyro->Y_Bias += (float)(bias[1] - tempComp->applied[1]);
+    gyro->Z_Bias += (float)(bias[2] - tempComp->applied[2]);
+    tempComp->applied[0] = bias[0];
+    tempComp->applied[1] = bias[1];
+    tempComp->applied[2] = bias[2];
+    tempComp->updates++;
+    I3G4250D_UpdateGain(gyro);
+}
+
+void I3G4250D_TempCompInit(I3G4250D_HandleTypeDef *gyro, const I3G4250D_TempBiasTypeDef *table, uint8_t points)
+{
+    // Take out the bias of a previous table first
+    I3G4250D_TempCompDisable(gyro);
+    gyro->tempComp.table = (points > 0) ? table : NULL;
+    gyro->tempComp.points = points;
+    gyro->tempComp.updates = 0;
+    gyro->tempComp.enabled = true;
+    I3G4250D_UpdateAxes(gyro);
+
+    // Apply the table before the first sample is scaled
+    I3G4250D_GetTemperature(gyro);
+}
+
+void I3G4250D_TempCompDisable(I3G4250D_HandleTypeDef *gyro)
+{
+    I3G4250D_TempCompTypeDef *tempComp = &gyro->tempComp;
+
+    gyro->X_Bias -= (float)tempComp->applied[0];
+    gyro->Y_Bias -= (float)tempComp->applied[1];
+    gyro->Z_Bias -= (float)tempComp->applied[2];
+    tempComp->applied[0] = 0;
+    tempComp->applied[1] = 0;
+    tempComp->applied[2] = 0;
+    tempComp->enabled = false;
+    tempComp->valid = false;
+    tempComp->table = NULL;
+    I3G4250D_UpdateGain(gyro);
+    I3G4250D_UpdateAxes(gyro);
+}
+
+int8_t I3G4250D_GetTemperature(I3G4250D_HandleTypeDef *gyro)
+{
+    uint8_t raw = 0;
+
+    if (I3G4250D_ReadIO(gyro, I3G4250D_OUT_TEMP_ADDR, &raw, 1) == HAL_OK)
+    {
+        I3G4250D_TempUpdate(gyro, raw);
+    }
+
+    return gyro->tempComp.temperature;
+}
+
+HAL_StatusTypeDef I3G4250D_ConfigureWakeup(I3G4250D_HandleTypeDef *gyro, uint32_t thresholdMdps, uint8_t axes, uint16_t durationMs, bool andEvents)
+{
+    uint8_t values[7];
+    uint32_t threshold = (uint32_t)I3G4250D_ToFixed((float)thresholdMdps / gyro->Sensitivity, 1.0f);
+    uint32_t duration = ((uint32_t)durationMs * I3G4250D_ODR_HZ_DR_00) / 1000;
+
+    if (gyro->dmaBusy)
+    {
+        return HAL_BUSY;
+    }
+    if (threshold > 0x7FFF)
+    {
+        threshold = 0x7FFF;
+    }
+    if (duration > I3G4250D_INT1_DURATION_MAX)
+    {
+        duration = I3G4250D_INT1_DURATION_MAX;
+    }
+
+    // INT1_THS_XH..INT1_THS_ZL and INT1_DURATION in one burst, every axis shares the threshold
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        values[2 * axis] = (uint8_t)(threshold >> 8);
+        values[(2 * axis) + 1] = (uint8_t)(threshold & 0xFF);
+    }
+    values[6] = (uint8_t)(duration > 0 ? (I3G4250D_INT1_DURATION_WAIT | duration) : 0);
+
+    gyro->wakeConfig = (uint8_t)((axes & I3G4250D_WAKE_ALL_AXIS) | I3G4250D_INT1_CFG_LIR | (andEvents ? I3G4250D_INT1_CFG_AND_OR : 0));
+    return I3G4250D_WriteRegisters(gyro, I3G4250D_INT1_THS_XH_REG, values, sizeof(values));
+}
+
+HAL_StatusTypeDef I3G4250D_EnterSleep(I3G4250D_HandleTypeDef *gyro)
+{
+    uint8_t values[5];
+    uint8_t source = 0;
+    HAL_StatusTypeDef status;
+
+    if (gyro->dmaBusy)
+    {
+        return HAL_BUSY;
+    }
+    if (gyro->sleeping || gyro->wakeConfig == 0)
+    {
+        return HAL_ERROR;
+    }
+    memcpy(gyro->sleepSaved, gyro->shadow, sizeof(gyro->sleepSaved));
+
+    //** 1. Stop INT2, disable the FIFO and drop to the lowest ODR, keeping the axes, filter and full scale **//
+    values[0] = (uint8_t)((gyro->sleepSaved[0] & 0x0F) | I3G4250D_ODR_BW_LOW);
+    values[1] = gyro->sleepSaved[1];
+    values[2] = 0;
+    values[3] = gyro->sleepSaved[3];
+    values[4] = (uint8_t)(gyro->sleepSaved[4] & ~I3G4250D_CTRL_REG5_FIFO_EN);
+    status = I3G4250D_WriteRegisters(gyro, I3G4250D_CTRL_REG1, values, sizeof(values));
+    if (status == HAL_OK)
+    {
+        status = I3G4250D_WriteRegister(gyro, I3G4250D_FIFO_CTRL_REG, I3G4250D_FIFO_MODE_BYPASS);
+    }
+
+    //** 2. Arm the threshold interrupt, clear a stale latch and route it to INT1 **//
+    if (status == HAL_OK)
+    {
+        status = I3G4250D_WriteRegister(gyro, I3G4250D_INT1_CFG_REG, gyro->wakeConfig);
+    }
+    if (status == HAL_OK)
+    {
+        status = I3G4250D_ReadIO(gyro, I3G4250D_INT1_SRC_REG, &source, 1);
+    }
+    if (status == HAL_OK)
+    {
+        gyro->wakePending = false;
+        gyro->sleeping = true;
+        status = I3G4250D_WriteRegister(gyro, I3G4250D_CTRL_REG3, I3G4250D_CTRL_REG3_I1_INT1);
+    }
+    return status;
+}
+
+HAL_StatusTypeDef I3G4250D_Wake(I3G4250D_HandleTypeDef *gyro)
+{
+    HAL_StatusTypeDef status;
+
+    if (!gyro->sleeping)
+    {
+        return HAL_OK;
+    }
+
+    // Disarm INT1 first, then restore FIFO_CTRL before CTRL_REG5 enables the FIFO again
+    status = I3G4250D_WriteRegister(gyro, I3G4250D_INT1_CFG_REG, gyro->sleepSaved[6]);
+    if (status == HAL_OK)
+    {
+        status = I3G4250D_WriteRegister(gyro, I3G4250D_FIFO_CTRL_REG, gyro->sleepSaved[5]);
+    }
+    if (status == HAL_OK)
+    {
+        status = I3G4250D_WriteRegisters(gyro, I3G4250D_CTRL_REG1, gyro->sleepSaved, 5);
+    }
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+    gyro->sleeping = false;
+    gyro->wakeups++;
+    gyro->fifoTimestamp = I3G4250D_GetTimestamp();
+    // Samples left unread while sleeping were not lost, keep the first read from counting them as overruns
+    gyro->overrunReported = I3G4250D_STATUS_OVERRUN;
+
+    // The output registers were not read while sleeping, so no new data ready edge would follow without one read
+    if (gyro->drdyMode == I3G4250D_DRDY_INT2)
+    {
+        I3G4250D_INT2_CaptureHandler(gyro, I3G4250D_GetTimestamp());
+    }
+    return HAL_OK;
+}
+
+bool I3G4250D_IsSleeping(I3G4250D_HandleTypeDef *gyro)
+{
+    return gyro->sleeping;
+}
+
+void I3G4250D_RegisterWakeCallback(I3G4250D_HandleTypeDef *gyro, I3G4250D_WakeCallback callback)
+{
+    gyro->wakeCallback = callback;
+}
+
+void I3G4250D_INT1_IRQHandler(I3G4250D_HandleTypeDef *gyro)
+{
+    // Only noted here, the blocking transfers of the wakeup are done by I3G4250D_WakeService
+    if (gyro->sleeping)
+    {
+        gyro->wakePending = true;
+    }
+}
+
+bool I3G4250D_WakeService(I3G4250D_HandleTypeDef *gyro)
+{
+    uint8_t source = 0;
+
+    if (!gyro->wakePending || gyro->dmaBusy)
+    {
+        return false;
+    }
+    // Woken up by I3G4250D_Wake meanwhile
+    if (!gyro->sleeping)
+    {
+        gyro->wakePending = false;
+        return false;
+    }
+    // Reading INT1_SRC_REG releases the latched interrupt, on a failed transfer the wakeup stays pending for the next call
+    if (I3G4250D_ReadIO(gyro, I3G4250D_INT1_SRC_REG, &source, 1) != HAL_OK || I3G4250D_Wake(gyro) != HAL_OK)
+    {
+        return false;
+    }
+    gyro->wakePending = false;
+    if (gyro->wakeCallback != NULL)
+    {
+        gyro->wakeCallback(gyro, source);
+    }
+    return true;
+}
+
+#ifdef I3G4250D_ENABLE_STATS
+// Count a failed transfer
+static void I3G4250D_StatsStatus(I3G4250D_HandleTypeDef *gyro, HAL_StatusTypeDef status)
+{
+    if (status == HAL_TIMEOUT)
+    {
+        gyro->stats.spiTimeouts++;
+    }
+    else if (status != HAL_OK)
+    {
+        gyro->stats.spiErrors++;
+    }
+}
+
+// Record the duration and outcome of a blocking transaction that started at `start`
+static void I3G4250D_StatsTransaction(I3G4250D_HandleTypeDef *gyro, bool read, uint32_t start, HAL_StatusTypeDef status)
+{
+    uint32_t cycles = I3G4250D_GetTimestamp() - start;
+    I3G4250D_TransactionStatsTypeDef *transactions = read ? &gyro->stats.read : &gyro->stats.write;
+
+    transactions->count++;
+    transactions->cyclesTotal += cycles;
+    if (cycles < transactions->cyclesMin)
+    {
+        transactions->cyclesMin = cycles;
+    }
+    if (cycles > transactions->cyclesMax)
+    {
+        transactions->cyclesMax = cycles;
+    }
+    I3G4250D_StatsStatus(gyro, status);
+}
+
+// Count delivered samples, the rate is updated once every second of timestamp ticks
+static void I3G4250D_StatsSamples(I3G4250D_HandleTypeDef *gyro, size_t count)
+{
+    uint32_t now = I3G4250D_GetTimestamp();
+    uint32_t elapsed = now - gyro->stats.windowStart;
+    uint32_t frequency = I3G4250D_GetTimestampFrequency();
+
+    gyro->stats.samplesDelivered += (uint32_t)count;
+    gyro->stats.windowSamples += (uint32_t)count;
+    if (elapsed >= frequency)
+    {
+        gyro->stats.samplesPerSecond = (uint32_t)(((uint64_t)gyro->stats.windowSamples * frequency) / elapsed);
+        gyro->stats.windowSamples = 0;
+        gyro->stats.windowStart = now;
+    }
+}
+
+void I3G4250D_GetStats(I3G4250D_HandleTypeDef *gyro, I3G4250D_StatsTypeDef *stats)
+{
+    memcpy(stats, &gyro->stats, sizeof(*stats));
+}
+
+void I3G4250D_ResetStats(I3G4250D_HandleTypeDef *gyro)
+{
+    memset(&gyro->stats, 0, sizeof(gyro->stats));
+    gyro->stats.read.cyclesMin = UINT32_MAX;
+    gyro->stats.write.cyclesMin = UINT32_MAX;
+    gyro->stats.windowStart = I3G4250D_GetTimestamp();
+}
+
+uint32_t I3G4250D_StatsAverageCycles(const I3G4250D_TransactionStatsTypeDef *transactions)
+{
+    if (transactions->count == 0)
+    {
+        return 0;
+    }
+    return (uint32_t)(transactions->cyclesTotal / transactions->count);
+}
+#endif
@@ -15,18 +15,27 @@ References:
    or indirectly by this software, read more about this on the GNU General Public License.
 */
 
-#include "stm32f4xx_hal.h"
+#ifndef I3G4250D_H
+#define I3G4250D_H
+
+#include "I3G4250D_Port.h"
 #include <stdbool.h>
 #include <string.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 // Register adresses
 #define I3G4250D_WHO_AM_I_ADDR           0x0F
+#define I3G4250D_WHO_AM_I_VALUE          0xD3
 #define I3G4250D_CTRL_REG1               0x20
 #define I3G4250D_CTRL_REG2               0x21
 #define I3G4250D_CTRL_REG3               0x22
 #define I3G4250D_CTRL_REG4               0x23
 #define I3G4250D_CTRL_REG5               0x24
 
+#define I3G4250D_OUT_TEMP_ADDR           0x26
 #define I3G4250D_STATUS_ADDR             0x27
 
 #define I3G4250D_OUT_X_L_ADDR            0x28
@@ -36,6 +45,30 @@ References:
 #define I3G4250D_OUT_Z_L_ADDR            0x2C
 #define I3G4250D_OUT_Z_H_ADDR            0x2D
 
+#define I3G4250D_FIFO_CTRL_REG           0x2E
+#define I3G4250D_FIFO_SRC_REG            0x2F
+
+#define I3G4250D_INT1_CFG_REG            0x30
+#define I3G4250D_INT1_SRC_REG            0x31
+#define I3G4250D_INT1_THS_XH_REG         0x32
+#define I3G4250D_INT1_THS_XL_REG         0x33
+#define I3G4250D_INT1_THS_YH_REG         0x34
+#define I3G4250D_INT1_THS_YL_REG         0x35
+#define I3G4250D_INT1_THS_ZH_REG         0x36
+#define I3G4250D_INT1_THS_ZL_REG         0x37
+#define I3G4250D_INT1_DURATION_REG       0x38
+
+// SPI address byte flags
+#define I3G4250D_SPI_READ                ((uint8_t)0x80)       // RW bit: read from the addressed register
+#define I3G4250D_SPI_AUTO_INCREMENT      ((uint8_t)0x40)       // MS bit: auto-increment the address on multi-byte transfers
+
+// Size of an axis burst: 1 address byte followed by OUT_X_L..OUT_Z_H
+#define I3G4250D_AXIS_BURST_SIZE         7
+// Size of a status burst: 1 address byte followed by STATUS_REG and OUT_X_L..OUT_Z_H
+#define I3G4250D_STATUS_BURST_SIZE       8
+// Size of a temperature burst: 1 address byte followed by OUT_TEMP, STATUS_REG and OUT_X_L..OUT_Z_H
+#define I3G4250D_TEMP_BURST_SIZE         9
+
 
 // Datarate
 #define I3G4250D_DATARATE_100            ((uint8_t)0x00)       // 100 HZ
@@ -100,6 +133,103 @@ Values are measured in MDPS/digit. (See referenced datasheet table 4. for more i
 #define I3G4250D_ENABLE_Y                ((uint8_t)0x0A)       // Enables ONLY the Y axis
 #define I3G4250D_ENABLE_X                ((uint8_t)0x09)       // Enables ONLY the X axis
 
+// FIFO modes (FM2-FM0 bits of FIFO_CTRL_REG, see referenced datasheet table 43.)
+#define I3G4250D_FIFO_MODE_BYPASS           ((uint8_t)0x00)    // FIFO disabled, output registers updated directly
+#define I3G4250D_FIFO_MODE_FIFO             ((uint8_t)0x20)    // Collect samples until the FIFO is full, then stop
+#define I3G4250D_FIFO_MODE_STREAM           ((uint8_t)0x40)    // Keep collecting, oldest sample is overwritten when full
+#define I3G4250D_FIFO_MODE_STREAM_TO_FIFO   ((uint8_t)0x60)    // Stream until an INT1 event, then switch to FIFO mode
+#define I3G4250D_FIFO_MODE_BYPASS_TO_STREAM ((uint8_t)0x80)    // Bypass until an INT1 event, then switch to stream mode
+
+#define I3G4250D_FIFO_SIZE               32                    // Number of samples the FIFO can hold
+
+// CTRL_REG1 bits
+#define I3G4250D_CTRL_REG1_PD           ((uint8_t)0x08)       // Normal mode, power down when clear
+
+// CTRL_REG3 bits
+#define I3G4250D_CTRL_REG3_I1_INT1       ((uint8_t)0x80)       // Interrupt enable on INT1
+#define I3G4250D_CTRL_REG3_I1_BOOT       ((uint8_t)0x40)       // Boot status available on INT1
+#define I3G4250D_CTRL_REG3_H_LACTIVE     ((uint8_t)0x20)       // Interrupt active low
+#define I3G4250D_CTRL_REG3_PP_OD         ((uint8_t)0x10)       // Open drain interrupt outputs
+#define I3G4250D_CTRL_REG3_I2_DRDY       ((uint8_t)0x08)       // Data ready on INT2
+#define I3G4250D_CTRL_REG3_I2_WTM        ((uint8_t)0x04)       // FIFO watermark on INT2
+#define I3G4250D_CTRL_REG3_I2_ORUN       ((uint8_t)0x02)       // FIFO overrun on INT2
+#define I3G4250D_CTRL_REG3_I2_EMPTY      ((uint8_t)0x01)       // FIFO empty on INT2
+
+// Data ready modes
+#define I3G4250D_DRDY_POLLING            ((uint8_t)0x00)                       // Poll STATUS_REG with I3G4250D_DataReady
+#define I3G4250D_DRDY_INT2               I3G4250D_CTRL_REG3_I2_DRDY            // Fetch a sample on every INT2 data ready edge
+#define I3G4250D_DRDY_INT2_WTM           I3G4250D_CTRL_REG3_I2_WTM             // Drain the FIFO on every INT2 watermark edge
+
+// CTRL_REG5 bits
+#define I3G4250D_CTRL_REG5_FIFO_EN       ((uint8_t)0x40)
+
+// STATUS_REG bits
+#define I3G4250D_STATUS_ZYXOR            ((uint8_t)0x80)       // A sample of any axis was overwritten before it was read
+#define I3G4250D_STATUS_ZOR              ((uint8_t)0x40)
+#define I3G4250D_STATUS_YOR              ((uint8_t)0x20)
+#define I3G4250D_STATUS_XOR              ((uint8_t)0x10)
+#define I3G4250D_STATUS_ZYXDA            ((uint8_t)0x08)       // New data is available on any axis
+#define I3G4250D_STATUS_ZDA              ((uint8_t)0x04)
+#define I3G4250D_STATUS_YDA              ((uint8_t)0x02)
+#define I3G4250D_STATUS_XDA              ((uint8_t)0x01)
+#define I3G4250D_STATUS_OVERRUN          ((uint8_t)0xF0)       // All overrun bits, also the flags passed to the overrun callback
+
+// INT1_CFG_REG bits
+#define I3G4250D_INT1_CFG_AND_OR         ((uint8_t)0x80)       // Interrupt on all enabled events instead of any
+#define I3G4250D_INT1_CFG_LIR            ((uint8_t)0x40)       // Latch the interrupt until INT1_SRC_REG is read
+#define I3G4250D_INT1_CFG_ZHIE           ((uint8_t)0x20)       // Z rate above threshold
+#define I3G4250D_INT1_CFG_ZLIE           ((uint8_t)0x10)       // Z rate below threshold
+#define I3G4250D_INT1_CFG_YHIE           ((uint8_t)0x08)
+#define I3G4250D_INT1_CFG_YLIE           ((uint8_t)0x04)
+#define I3G4250D_INT1_CFG_XHIE           ((uint8_t)0x02)
+#define I3G4250D_INT1_CFG_XLIE           ((uint8_t)0x01)
+
+// Wake-on-motion axes
+#define I3G4250D_WAKE_X                  I3G4250D_INT1_CFG_XHIE
+#define I3G4250D_WAKE_Y                  I3G4250D_INT1_CFG_YHIE
+#define I3G4250D_WAKE_Z                  I3G4250D_INT1_CFG_ZHIE
+#define I3G4250D_WAKE_ALL_AXIS           ((uint8_t)(I3G4250D_WAKE_X | I3G4250D_WAKE_Y | I3G4250D_WAKE_Z))
+
+// INT1_SRC_REG bits
+#define I3G4250D_INT1_SRC_IA             ((uint8_t)0x40)       // Interrupt active
+
+// INT1_DURATION_REG bits
+#define I3G4250D_INT1_DURATION_WAIT      ((uint8_t)0x80)       // The duration also applies to the end of an event
+#define I3G4250D_INT1_DURATION_MAX       0x7F                  // Samples
+
+// FIFO_SRC_REG bits
+#define I3G4250D_FIFO_SRC_WTM            ((uint8_t)0x80)       // FIFO level is equal to or above the watermark
+#define I3G4250D_FIFO_SRC_OVRN           ((uint8_t)0x40)       // FIFO is full and a sample was overwritten
+#define I3G4250D_FIFO_SRC_EMPTY          ((uint8_t)0x20)       // FIFO is empty
+#define I3G4250D_FIFO_SRC_FSS            ((uint8_t)0x1F)       // Number of samples stored in the FIFO
+
+// Shadow register cache: CTRL_REG1..CTRL_REG5, FIFO_CTRL_REG and INT1_CFG_REG
+#define I3G4250D_SHADOW_SIZE             7
+
+// Sample ring buffer capacity, must be a power of two
+#ifndef I3G4250D_RING_SIZE
+#define I3G4250D_RING_SIZE               64
+#endif
+#if (I3G4250D_RING_SIZE & (I3G4250D_RING_SIZE - 1)) != 0
+#error "I3G4250D_RING_SIZE must be a power of two"
+#endif
+
+// Samples per axis of a capture block, a power of two from 32 so a block is a valid arm_rfft_q15 length
+#ifndef I3G4250D_BLOCK_SIZE
+#define I3G4250D_BLOCK_SIZE              256
+#endif
+#if (I3G4250D_BLOCK_SIZE < 32) || ((I3G4250D_BLOCK_SIZE & (I3G4250D_BLOCK_SIZE - 1)) != 0)
+#error "I3G4250D_BLOCK_SIZE must be a power of two of at least 32"
+#endif
+#ifndef I3G4250D_BLOCK_ALIGN
+#define I3G4250D_BLOCK_ALIGN             8                     // Byte alignment of the per-axis arrays
+#endif
+
+// OUT_TEMP reads OFFSET - temperature at -1 digit/degree, the offset is not trimmed, see I3G4250D_TempCompInit
+#ifndef I3G4250D_TEMP_OFFSET
+#define I3G4250D_TEMP_OFFSET             25
+#endif
+
 //Typedefs
 typedef struct
 {
@@ -108,8 +238,37 @@ typedef struct
     uint8_t HPF_MODE;                                           // Highpass filter mode
     uint8_t HPCF_MODE;                                          // Highpass filter cutoff frequency
     uint8_t FULLSCALE_SELECTION;                                   
+    uint8_t FIFO_MODE;                                          // FIFO mode, I3G4250D_FIFO_MODE_BYPASS disables the FIFO
+    uint8_t FIFO_WATERMARK;                                     // FIFO watermark level (0 - 31 samples)
+    uint8_t DRDY_MODE;                                          // Data ready mode, polling or INT2 interrupt driven
 } I3G4250D_InitTypeDef;
 
+// Non-blocking initialization, see I3G4250D_InitStart
+typedef enum
+{
+    I3G4250D_INIT_PROBE = 0,                                    // Waiting for WHO_AM_I to read I3G4250D_WHO_AM_I_VALUE
+    I3G4250D_INIT_CONFIGURE,                                    // Identity confirmed, configuration is written next
+    I3G4250D_INIT_TURN_ON,                                      // Waiting for the first sample
+    I3G4250D_INIT_READY,
+    I3G4250D_INIT_ERROR_ID,                                     // No I3G4250D answered within I3G4250D_INIT_PROBE_TIMEOUT
+    I3G4250D_INIT_ERROR_TURN_ON,                                // No sample within I3G4250D_INIT_TURN_ON_TIMEOUT
+    I3G4250D_INIT_ERROR_INSTANCE,                               // All I3G4250D_MAX_INSTANCES handles are registered already
+    I3G4250D_INIT_ERROR_CONFIGURE                               // The configuration could not be written
+} I3G4250D_InitStateTypeDef;
+
+#ifndef I3G4250D_INIT_PROBE_TIMEOUT
+#define I3G4250D_INIT_PROBE_TIMEOUT      50                    // MS, covers the boot time after power up
+#endif
+#ifndef I3G4250D_INIT_TURN_ON_TIMEOUT
+#define I3G4250D_INIT_TURN_ON_TIMEOUT    250                   // MS from leaving power down to the first sample
+#endif
+
+// SPI clock tuning
+#define I3G4250D_SPI_MAX_HZ              10000000U             // Maximum SPI clock of the datasheet
+#ifndef I3G4250D_SPI_TUNE_ITERATIONS
+#define I3G4250D_SPI_TUNE_ITERATIONS     32                    // Readback rounds a prescaler has to pass
+#endif
+
 // Accelerometer data
 typedef struct
 {
@@ -125,21 +284,585 @@ typedef struct
     float z;
 } I3G4250D_DataScaled;
 
+// Fixed-point scaled data in MDPS
+typedef struct
+{
+    int32_t x;
+    int32_t y;
+    int32_t z;
+} I3G4250D_DataFixed;
+
+// Timestamped sample, the timestamp is in I3G4250D_GetTimestamp ticks
+typedef struct
+{
+    I3G4250D_DataRaw data;
+    uint32_t timestamp;
+} I3G4250D_DataStamped;
+
+// Sample ring buffer, head is only written by the producer and tail only by the consumer
+typedef struct
+{
+    I3G4250D_DataRaw samples[I3G4250D_RING_SIZE];
+    uint32_t timestamps[I3G4250D_RING_SIZE];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t overflows;
+} I3G4250D_RingTypeDef;
+
+// Capture block, one array per axis
+typedef struct
+{
+    __ALIGNED(I3G4250D_BLOCK_ALIGN) int16_t x[I3G4250D_BLOCK_SIZE];
+    __ALIGNED(I3G4250D_BLOCK_ALIGN) int16_t y[I3G4250D_BLOCK_SIZE];
+    __ALIGNED(I3G4250D_BLOCK_ALIGN) int16_t z[I3G4250D_BLOCK_SIZE];
+    uint32_t timestamp;                                         // Of the first sample
+    uint32_t sequence;                                          // Counts the filled blocks, a gap shows dropped blocks
+} I3G4250D_BlockTypeDef;
+
+// Double buffered block capture state, see I3G4250D_BlockCaptureInit
+typedef struct
+{
+    I3G4250D_BlockTypeDef *blocks;                              // Two blocks owned by the application
+    bool enabled;
+    bool scaled;                                                // Store I3G4250D_ScaleBlockQ15 values instead of raw digits
+    uint8_t active;                                             // Block being filled, only written by the producer
+    uint8_t read;                                               // Next block handed out, only written by the consumer
+    uint16_t fill;
+    uint32_t sequence;
+    volatile bool full[2];
+    volatile uint32_t dropped;                                  // Samples lost because both blocks were full
+} I3G4250D_BlockCaptureTypeDef;
+
+// Online bias estimator state, see I3G4250D_BiasEstimatorInit
+typedef struct
+{
+    bool enabled;
+    bool stationary;
+    bool biasValid;
+    uint8_t filterShift;                                        // Mean and variance filters average over 2^filterShift samples
+    uint8_t biasShift;                                          // Each update moves the bias 1/2^biasShift towards the stationary mean
+    uint16_t minStillSamples;                                   // Stationary samples required before the bias is updated
+    uint16_t stillCount;
+    uint32_t varianceThreshold;                                 // Maximum variance in digits^2 that counts as stationary
+    uint32_t samples;
+    int32_t mean[3];                                            // Q24.8 digits
+    int32_t variance[3];                                        // Q24.8 digits^2
+    int32_t bias[3];                                            // Q24.8 digits
+} I3G4250D_BiasEstimatorTypeDef;
+
+#ifdef I3G4250D_ENABLE_STATS
+// Duration of blocking SPI transactions in I3G4250D_GetTimestamp ticks
+typedef struct
+{
+    uint32_t count;
+    uint32_t cyclesMin;
+    uint32_t cyclesMax;
+    uint64_t cyclesTotal;
+} I3G4250D_TransactionStatsTypeDef;
+
+// Driver instrumentation, see I3G4250D_GetStats
+typedef struct
+{
+    I3G4250D_TransactionStatsTypeDef read;                      // ReadIO and read transfers
+    I3G4250D_TransactionStatsTypeDef write;                     // WriteIO and register writes
+    uint32_t spiErrors;                                         // HAL_ERROR returned by the HAL or raised through I3G4250D_ErrorHandler
+    uint32_t spiTimeouts;                                       // HAL_TIMEOUT returned by the HAL
+    uint32_t pollIterations;                                    // STATUS_REG reads done by I3G4250D_DataReady
+    uint32_t samplesDelivered;                                  // Samples returned by all read paths since the last reset
+    uint32_t samplesPerSecond;                                  // Rate over the last full second
+    uint32_t windowStart;
+    uint32_t windowSamples;
+} I3G4250D_StatsTypeDef;
+#endif
+
+// Adaptive output data rate state, see I3G4250D_AdaptiveOdrInit
+typedef struct
+{
+    bool enabled;
+    bool high;                                                  // Running at highPreset
+    uint8_t lowPreset;
+    uint8_t highPreset;
+    uint32_t thresholdMdps;
+    int32_t thresholdDigits;                                    // thresholdMdps at the current sensitivity, kept by I3G4250D_UpdateGain
+    uint32_t quietSamples;                                      // Samples below the threshold at highPreset before switching down
+    uint32_t quietCount;
+    uint32_t switches;
+    volatile bool pending;                                      // A switch to pendingPreset was decided and not written yet
+    uint8_t pendingPreset;
+} I3G4250D_AdaptiveOdrTypeDef;
+
+// CIC decimator limits
+#define I3G4250D_DECIMATOR_MAX_ORDER     4
+#define I3G4250D_DECIMATOR_MAX_RATIO     32
+
+// CIC decimator state, see I3G4250D_DecimatorInit
+typedef struct
+{
+    bool enabled;
+    uint8_t ratio;
+    uint8_t order;
+    uint8_t phase;                                              // Input samples since the last output
+    uint32_t gain;                                              // ratio^order
+    uint32_t integrators[I3G4250D_DECIMATOR_MAX_ORDER][3];      // Modulo 2^32, the comb stages undo the wrap around
+    uint32_t combs[I3G4250D_DECIMATOR_MAX_ORDER][3];
+    I3G4250D_DataRaw output[I3G4250D_FIFO_SIZE / 2];
+} I3G4250D_DecimatorTypeDef;
+
+// Zero rate level of every axis at one temperature, an entry of the table of I3G4250D_TempCompInit
+typedef struct
+{
+    int8_t temperature;                                         // Degrees C as returned by I3G4250D_GetTemperature
+    int16_t x;                                                  // MDPS
+    int16_t y;
+    int16_t z;
+} I3G4250D_TempBiasTypeDef;
+
+// Temperature compensation state, see I3G4250D_TempCompInit
+typedef struct
+{
+    bool enabled;
+    bool valid;                                                 // temperature holds a reading
+    int8_t temperature;                                         // Last temperature in degrees C
+    uint8_t raw;                                                // OUT_TEMP of the last reading
+    uint8_t points;
+    const I3G4250D_TempBiasTypeDef *table;
+    int32_t applied[3];                                         // Table bias in MDPS currently included in X_Bias, Y_Bias and Z_Bias
+    uint32_t updates;                                           // Number of times the bias was moved
+} I3G4250D_TempCompTypeDef;
+
+typedef struct I3G4250D_HandleTypeDef I3G4250D_HandleTypeDef;
+
+// Called from the DMA completion path with the decoded samples
+typedef void (*I3G4250D_DataCallback)(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *data, size_t count);
+
+// Called from the read path that detected the overrun, with the STATUS_REG overrun bits and the number of samples lost per flagged axis
+typedef void (*I3G4250D_OverrunCallback)(I3G4250D_HandleTypeDef *gyro, uint8_t flags, uint32_t lost);
+
+// Called from I3G4250D_WakeService once the gyroscope is streaming again, with the INT1_SRC_REG value of the wakeup
+typedef void (*I3G4250D_WakeCallback)(I3G4250D_HandleTypeDef *gyro, uint8_t source);
+
+// Samples overwritten before they were read, see I3G4250D_GetOverruns
+typedef struct
+{
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+    uint32_t events;                                            // Number of times an overrun was detected
+} I3G4250D_OverrunTypeDef;
+
+// Device handle, one per gyroscope. Filled in by I3G4250D_Init.
+struct I3G4250D_HandleTypeDef
+{
+    SPI_HandleTypeDef *SPI_Handle;                              // SPI bus the gyroscope is connected to
+    GPIO_TypeDef *CS_Port;                                      // Chip select port
+    uint16_t CS_Pin;                                            // Chip select pin
+
+    // Sensitivity, bias and scaling
+    float Sensitivity;
+    float X_Bias;
+    float Y_Bias;
+    float Z_Bias;
+    float X_Scale;
+    float Y_Scale;
+    float Z_Scale;
+
+    // Per-axis gain and offset precomputed from the sensitivity, scale and bias by I3G4250D_UpdateGain
+    float X_Gain;                                               // MDPS/digit
+    float Y_Gain;
+    float Z_Gain;
+    int32_t X_GainQ16;                                          // MDPS/digit in Q16.16
+    int32_t Y_GainQ16;
+    int32_t Z_GainQ16;
+    int32_t X_Offset;                                           // MDPS
+    int32_t Y_Offset;
+    int32_t Z_Offset;
+    float X_OffsetFloat;                                        // MDPS, the bias of an enabled axis and 0 otherwise
+    float Y_OffsetFloat;
+    float Z_OffsetFloat;
+    int16_t X_GainQ15;                                          // Scale as a q15 fraction, shifted left by GainShiftQ15
+    int16_t Y_GainQ15;
+    int16_t Z_GainQ15;
+    uint8_t GainShiftQ15;                                       // Shared by all axes so the block kernel can process two axes per instruction
+    int16_t X_OffsetQ15;                                        // Bias in digits
+    int16_t Y_OffsetQ15;
+    int16_t Z_OffsetQ15;
+
+    // RAM copy of the configuration registers, see I3G4250D_WriteRegisters
+    uint8_t shadow[I3G4250D_SHADOW_SIZE];
+    uint8_t shadowStale;                                        // Bit i set when a failed write left shadow[i] unconfirmed
+
+    // Enabled axes from CTRL_REG1 and the single sample burst that covers them, in a frame laid out like I3G4250D_TEMP_BURST_SIZE
+    uint8_t axisMask;
+    uint8_t axisFrameOffset;
+    uint8_t axisFrameSize;
+
+    // Timestamping
+    uint32_t samplePeriod;                                      // Timestamp ticks per sample at the configured ODR
+    volatile uint32_t drdyTimestamp;                            // Timestamp of the last INT2 edge
+    uint32_t blockTimestamp;                                    // Timestamp of the newest sample of the last DMA block
+
+    // Interrupt and DMA state
+    uint8_t drdyMode;
+    uint8_t fifoWatermark;
+    volatile bool drdyFlag;
+    volatile bool irqPending;
+    volatile bool dmaBusy;
+    size_t dmaSampleCount;
+    I3G4250D_DataCallback dataCallback;
+
+    // Sample loss accounting
+    I3G4250D_OverrunTypeDef overruns;
+    I3G4250D_OverrunCallback overrunCallback;
+    uint8_t overrunReported;                                    // Overrun bits already counted since the last data read
+    uint32_t fifoTimestamp;                                     // Timestamp of the last FIFO drain
+
+    // Burst frame: 1 address byte, OUT_TEMP and STATUS_REG followed by up to 32 samples of 6 bytes, shared by the FIFO and DMA reads
+    uint8_t burstFrame[3 + (I3G4250D_FIFO_SIZE * 6)];
+    I3G4250D_DataRaw dmaSamples[I3G4250D_FIFO_SIZE];
+
+    I3G4250D_RingTypeDef ring;
+    I3G4250D_BlockCaptureTypeDef blockCapture;
+    I3G4250D_BiasEstimatorTypeDef biasEstimator;
+    I3G4250D_AdaptiveOdrTypeDef adaptiveOdr;
+    I3G4250D_DecimatorTypeDef decimator;
+    I3G4250D_TempCompTypeDef tempComp;
+
+    // Wake-on-motion
+    volatile bool sleeping;
+    volatile bool wakePending;                                  // Set by I3G4250D_INT1_IRQHandler, cleared by I3G4250D_WakeService
+    uint8_t wakeConfig;                                         // INT1_CFG_REG value while sleeping
+    uint8_t sleepSaved[I3G4250D_SHADOW_SIZE];                   // Streaming configuration restored on wakeup
+    uint32_t wakeups;
+    I3G4250D_WakeCallback wakeCallback;
+
+    // Non-blocking initialization
+    I3G4250D_InitStateTypeDef initState;
+    I3G4250D_InitTypeDef initConfig;
+    uint32_t initTick;
+    uint8_t whoAmI;                                             // Last WHO_AM_I value read while probing
+
+#ifdef I3G4250D_ENABLE_STATS
+    I3G4250D_StatsTypeDef stats;
+#endif
+};
+
+// Nominal output data rates in HZ, indexed by the DR1-DR0 bits of CTRL_REG1 (See referenced datasheet table 21.)
+#define I3G4250D_ODR_HZ_DR_00            105
+#define I3G4250D_ODR_HZ_DR_01            208
+#define I3G4250D_ODR_HZ_DR_10            420
+#define I3G4250D_ODR_HZ_DR_11            840
+
+// Maximum number of gyroscopes the SPI completion handlers can dispatch to
+#ifndef I3G4250D_MAX_INSTANCES
+#define I3G4250D_MAX_INSTANCES           4
+#endif
+
+// Chip select of the gyroscope on the STM32F429I-DISC1
+#define I3G4250D_DISC1_CS_PORT           GPIOC
+#define I3G4250D_DISC1_CS_PIN            GPIO_PIN_1
+
 // Function prototypes
-// Read IO
-void I3G4250D_WriteIO(uint8_t registerAddress, uint8_t *writeData, uint8_t size);
-// Write IO
-void I3G4250D_ReadIO(uint8_t registerAddress, uint8_t *readData, uint8_t size);
+// Write IO, returns the bus lock status when the bus could not be taken
+HAL_StatusTypeDef I3G4250D_WriteIO(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress, uint8_t *writeData, uint16_t size);
+// Read IO, readData is left untouched unless HAL_OK is returned
+HAL_StatusTypeDef I3G4250D_ReadIO(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress, uint8_t *readData, uint16_t size);
+// Full-duplex transaction
+/* NOTE:
+frame[0] is the address byte (register address | I3G4250D_SPI_READ / I3G4250D_SPI_AUTO_INCREMENT), followed by size - 1 data bytes.
+The frame is transmitted and received in place with a single HAL_SPI_TransmitReceive: on return frame[1..size - 1] holds the bytes read
+from the gyroscope, so the caller's buffer is used directly without an intermediate copy or a length limit.
+*/
+HAL_StatusTypeDef I3G4250D_TransferIO(I3G4250D_HandleTypeDef *gyro, uint8_t *frame, uint16_t size);
+
+// Configuration registers
+/* NOTE:
+CTRL_REG1..CTRL_REG5, FIFO_CTRL_REG and INT1_CFG_REG are cached in the handle. Writes through these functions update the cache
+and only transfer the bytes that actually changed, so reconfiguring at runtime needs no read-modify-write round trip.
+Other registers are written unconditionally, as are cached registers whose last write failed.
+*/
+HAL_StatusTypeDef I3G4250D_WriteRegisters(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress, const uint8_t *values, uint8_t count);
+HAL_StatusTypeDef I3G4250D_WriteRegister(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress, uint8_t value);
+HAL_StatusTypeDef I3G4250D_ModifyRegister(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress, uint8_t mask, uint8_t value);
+uint8_t I3G4250D_GetShadowRegister(I3G4250D_HandleTypeDef *gyro, uint8_t registerAddress);
+
+HAL_StatusTypeDef I3G4250D_SetEnabledAxis(I3G4250D_HandleTypeDef *gyro, uint8_t enabledAxis);
+HAL_StatusTypeDef I3G4250D_SetODR(I3G4250D_HandleTypeDef *gyro, uint8_t odrBwPreset);
+HAL_StatusTypeDef I3G4250D_SetFullScale(I3G4250D_HandleTypeDef *gyro, uint8_t fullScale);
+HAL_StatusTypeDef I3G4250D_SetFifoMode(I3G4250D_HandleTypeDef *gyro, uint8_t fifoMode, uint8_t watermark);
+
+// Initialization, HAL_ERROR when I3G4250D_MAX_INSTANCES other handles are registered already or the configuration write failed
+HAL_StatusTypeDef I3G4250D_Init(I3G4250D_HandleTypeDef *gyro, SPI_HandleTypeDef *accelerometerSPI, GPIO_TypeDef *csPort, uint16_t csPin, I3G4250D_InitTypeDef *accelerometerInit);
+// Release the instance slot taken by I3G4250D_Init / I3G4250D_InitStart, the gyroscope itself is not accessed.
+// Initializing a handle again keeps its slot. HAL_BUSY during a DMA transfer, HAL_ERROR when the handle is not registered
+HAL_StatusTypeDef I3G4250D_DeInit(I3G4250D_HandleTypeDef *gyro);
+
+/* NOTE:
+I3G4250D_InitStart prepares the handle like I3G4250D_Init without touching the gyroscope, then I3G4250D_InitStep advances the
+initialization by at most one short blocking transaction per call and returns the current state: WHO_AM_I is probed until it
+reads I3G4250D_WHO_AM_I_VALUE, the configuration is written, and the first sample is awaited and discarded (it has not settled
+and reading it rearms the INT2 data ready edge). Step every sensor from the main loop or a timer tick until all of them report
+I3G4250D_INIT_READY, so they boot and turn on concurrently without fixed delays, e.g.
 
-// Initialization
-void I3G4250D_Init(SPI_HandleTypeDef *accelerometerSPI, I3G4250D_InitTypeDef *accelerometerInit);
+    bool done;
+    do
+    {
+        done = I3G4250D_InitStep(&gyro1) >= I3G4250D_INIT_READY;
+        done &= I3G4250D_InitStep(&gyro2) >= I3G4250D_INIT_READY;
+    } while (!done);
 
-I3G4250D_DataRaw I3G4250D_GetRawData(void);
-I3G4250D_DataScaled I3G4250D_GetScaledData(void);
-bool I3G4250D_DataReady(uint32_t msTimeOut);
+The I3G4250D_INIT_ERROR_ states are final, whoAmI holds the value read on an identity mismatch. I3G4250D_InitStart leaves
+the handle in I3G4250D_INIT_ERROR_INSTANCE when no instance slot is free, like I3G4250D_Init returning HAL_ERROR. A configuration
+write that fails, e.g. on a bus held by another driver, is retried until I3G4250D_INIT_PROBE_TIMEOUT before I3G4250D_INIT_ERROR_CONFIGURE.
+*/
+void I3G4250D_InitStart(I3G4250D_HandleTypeDef *gyro, SPI_HandleTypeDef *accelerometerSPI, GPIO_TypeDef *csPort, uint16_t csPin, const I3G4250D_InitTypeDef *accelerometerInit);
+I3G4250D_InitStateTypeDef I3G4250D_InitStep(I3G4250D_HandleTypeDef *gyro);
+
+// SPI clock tuning
+/* NOTE:
+I3G4250D_Init keeps the prescaler the SPI handle was configured with. I3G4250D_TuneSpiClock, called once the gyroscope is
+initialized, steps the prescaler from the fastest one at or below maxHz (e.g. I3G4250D_SPI_MAX_HZ, 0 tries every prescaler)
+to the slowest. At each step it rewrites the configuration registers from the shadow cache, then reads WHO_AM_I, CTRL_REG1..5,
+FIFO_CTRL_REG and INT1_CFG_REG back `iterations` times (0 for I3G4250D_SPI_TUNE_ITERATIONS), and keeps the first prescaler
+where every read matches. Without one it restores the original prescaler and returns HAL_ERROR.
+The prescaler is a property of the bus, so other devices on it run at the tuned clock too: only tune a shared bus with maxHz
+at or below the limit of its slowest device. The bus is locked for the whole run, no DMA transfer may be in progress.
+I3G4250D_GetSpiClock returns the current SPI clock in HZ, SPI2 and SPI3 run from APB1, the other instances from APB2.
+*/
+HAL_StatusTypeDef I3G4250D_TuneSpiClock(I3G4250D_HandleTypeDef *gyro, uint32_t maxHz, uint16_t iterations);
+uint32_t I3G4250D_GetSpiClock(I3G4250D_HandleTypeDef *gyro);
+
+I3G4250D_DataRaw I3G4250D_GetRawData(I3G4250D_HandleTypeDef *gyro);
+I3G4250D_DataScaled I3G4250D_GetScaledData(I3G4250D_HandleTypeDef *gyro);
+bool I3G4250D_DataReady(I3G4250D_HandleTypeDef *gyro, uint32_t msTimeOut);
+
+// Enabled axes
+/* NOTE:
+Without the FIFO, single sample reads (I3G4250D_GetRawData and the INT2 data ready / I3G4250D_GetRawDataDMA path) only transfer
+the shortest register span covering the axes enabled in CTRL_REG1, e.g. 3 bytes instead of 8 for I3G4250D_ENABLE_Z.
+STATUS_REG is only part of that span when X is enabled, otherwise overruns are only seen by I3G4250D_DataReady.
+With the FIFO enabled every read, single samples included, moves whole 6 byte slots since the FIFO only advances after OUT_Z_H. Disabled axes read as 0 in every path and their gain is 0 in every conversion.
+I3G4250D_GetRawAxes and I3G4250D_PackAxes return the enabled axes only, in X, Y, Z order, and the number of values written.
+*/
+uint8_t I3G4250D_GetRawAxes(I3G4250D_HandleTypeDef *gyro, int16_t *out);
+size_t I3G4250D_PackAxes(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *in, int16_t *out, size_t n);
+
+// Conversion of samples that were already read, e.g. popped from the ring buffer
+I3G4250D_DataScaled I3G4250D_ConvertScaled(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *raw);
+
+// Fixed-point scaling
+/* NOTE:
+The fixed-point functions return MDPS as int32 without any floating point math per sample, for cores without an FPU.
+The per-axis gain and offset are computed once by I3G4250D_Init and the calibration functions;
+call I3G4250D_UpdateGain after changing the bias or scale fields of the handle directly.
+*/
+I3G4250D_DataFixed I3G4250D_GetFixedData(I3G4250D_HandleTypeDef *gyro);
+I3G4250D_DataFixed I3G4250D_ConvertFixed(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *raw);
+void I3G4250D_UpdateGain(I3G4250D_HandleTypeDef *gyro);
+
+// Block conversion
+/* NOTE:
+Converts a block of samples, e.g. a FIFO drain or a ring buffer block, in one call.
+I3G4250D_ScaleBlockQ15 keeps the q15 format of the raw data: the output is the bias corrected and scaled value in digits,
+multiply by the sensitivity to get MDPS. On cores with the DSP extension (Cortex-M4/M7) it processes two axes per instruction.
+*/
+void I3G4250D_ScaleBlock(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *in, I3G4250D_DataScaled *out, size_t n);
+void I3G4250D_ScaleBlockFixed(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *in, I3G4250D_DataFixed *out, size_t n);
+void I3G4250D_ScaleBlockQ15(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *in, I3G4250D_DataRaw *out, size_t n);
+
+// FIFO
+size_t I3G4250D_ReadFifo(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataRaw *out, size_t max);
+
+// DMA
+/* NOTE:
+The DMA functions return immediately, the decoded samples are passed to the registered callback once the transfer completes.
+Call I3G4250D_TxRxCpltHandler and I3G4250D_ErrorHandler from HAL_SPI_TxRxCpltCallback and HAL_SPI_ErrorCallback,
+or define I3G4250D_USE_HAL_SPI_CALLBACKS to let the driver implement those HAL callbacks itself.
+The handlers look up the gyroscope by its SPI handle, so several gyroscopes on separate buses can transfer in parallel.
+The blocking read functions must not be used while a DMA transfer is in progress.
+*/
+void I3G4250D_RegisterCallback(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataCallback callback);
+HAL_StatusTypeDef I3G4250D_GetRawDataDMA(I3G4250D_HandleTypeDef *gyro);
+HAL_StatusTypeDef I3G4250D_ReadFifoDMA(I3G4250D_HandleTypeDef *gyro, size_t max);
+bool I3G4250D_DMABusy(I3G4250D_HandleTypeDef *gyro);
+void I3G4250D_TxRxCpltHandler(SPI_HandleTypeDef *hspi);
+void I3G4250D_ErrorHandler(SPI_HandleTypeDef *hspi);
+
+// Interrupts
+/* NOTE:
+When DRDY_MODE is I3G4250D_DRDY_INT2 or I3G4250D_DRDY_INT2_WTM, call I3G4250D_INT2_IRQHandler from HAL_GPIO_EXTI_Callback
+for the pin INT2 of that gyroscope is wired to (rising edge). The handler starts a DMA read, samples are delivered through the registered callback.
+In these modes I3G4250D_DataReady only checks whether an edge occurred and does not touch the SPI bus.
+*/
+void I3G4250D_INT2_IRQHandler(I3G4250D_HandleTypeDef *gyro);
+
+// Sample loss accounting
+/* NOTE:
+Every read path checks for samples that were overwritten before they were read: the polled and DMA reads through the
+ZYXOR bits of STATUS_REG (read in the same burst as the axis data), the FIFO reads through OVRN in FIFO_SRC_REG.
+The output registers hold a single sample, so without the FIFO every overrun counts as one lost sample per flagged axis,
+a lower bound. With the FIFO enabled the loss is estimated from the time since the previous drain and the ODR.
+An overrun seen by I3G4250D_DataReady and again by the data read that follows is only counted once.
+The callback runs in the context of the read, i.e. from the DMA completion interrupt in the INT2 modes.
+*/
+void I3G4250D_RegisterOverrunCallback(I3G4250D_HandleTypeDef *gyro, I3G4250D_OverrunCallback callback);
+void I3G4250D_GetOverruns(I3G4250D_HandleTypeDef *gyro, I3G4250D_OverrunTypeDef *overruns);
+void I3G4250D_ResetOverruns(I3G4250D_HandleTypeDef *gyro);
+
+// Timestamping
+/* NOTE:
+Samples read through the INT2 handler are stamped with the time of the data ready / watermark edge, other reads with the time of the read.
+For FIFO blocks the timestamps of the older samples are reconstructed from the output data rate, newest sample last.
+The default timestamp source is the DWT cycle counter (enabled by I3G4250D_TimestampInit); cores without DWT fall back to HAL_GetTick.
+Override the weak I3G4250D_TimestampInit, I3G4250D_GetTimestamp and I3G4250D_GetTimestampFrequency functions to use a timer instead,
+or pass a TIM input capture value to I3G4250D_INT2_CaptureHandler.
+*/
+void I3G4250D_TimestampInit(void);
+uint32_t I3G4250D_GetTimestamp(void);
+uint32_t I3G4250D_GetTimestampFrequency(void);
+uint32_t I3G4250D_GetODR(I3G4250D_HandleTypeDef *gyro);
+void I3G4250D_INT2_CaptureHandler(I3G4250D_HandleTypeDef *gyro, uint32_t timestamp);
+I3G4250D_DataStamped I3G4250D_GetStampedData(I3G4250D_HandleTypeDef *gyro);
+size_t I3G4250D_ReadFifoStamped(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataStamped *out, size_t max);
+
+// Sample ring buffer
+/* NOTE:
+Samples delivered by the DMA completion path are pushed into a single-producer/single-consumer ring buffer.
+The interrupt is the only producer and the application the only consumer, so no interrupt locking is required.
+When the ring is full new samples are dropped and counted in I3G4250D_RingOverflows.
+*/
+bool I3G4250D_RingPop(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataRaw *sample);
+size_t I3G4250D_RingPopBlock(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataRaw *out, size_t max);
+size_t I3G4250D_RingCount(I3G4250D_HandleTypeDef *gyro);
+uint32_t I3G4250D_RingOverflows(I3G4250D_HandleTypeDef *gyro);
+bool I3G4250D_RingPopStamped(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataStamped *sample);
+size_t I3G4250D_RingPopBlockStamped(I3G4250D_HandleTypeDef *gyro, I3G4250D_DataStamped *out, size_t max);
+
+// Block capture
+/* NOTE:
+I3G4250D_BlockCaptureInit de-interleaves every sample of the DMA completion path into the per-axis
+arrays of two application owned blocks, raw or, with scaled, bias corrected and scaled like I3G4250D_ScaleBlockQ15.
+While one block fills, the other stays with the application from I3G4250D_BlockGet until I3G4250D_BlockRelease, so it can be
+handed to arm_rfft_q15 as it is, e.g. arm_rfft_q15(&fft, block->z, spectrum) with a length of I3G4250D_BLOCK_SIZE
+(note that arm_rfft_q15 modifies its input). When both blocks are full new samples are dropped and counted.
+Like the ring buffer, the interrupt is the only producer and the application the only consumer, so blocking reads
+(I3G4250D_ReadFifo, I3G4250D_AutoCalibrate) return their samples to the caller only and never fill a block.
+*/
+void I3G4250D_BlockCaptureInit(I3G4250D_HandleTypeDef *gyro, I3G4250D_BlockTypeDef blocks[2], bool scaled);
+void I3G4250D_BlockCaptureDisable(I3G4250D_HandleTypeDef *gyro);
+I3G4250D_BlockTypeDef *I3G4250D_BlockGet(I3G4250D_HandleTypeDef *gyro);
+void I3G4250D_BlockRelease(I3G4250D_HandleTypeDef *gyro);
+uint32_t I3G4250D_BlockDropped(I3G4250D_HandleTypeDef *gyro);
 
 // Calibration
 
-void I3G4250D_X_Calibrate(float x_min, float x_max);
-void I3G4250D_Y_Calibrate(float y_min, float y_max);
-void I3G4250D_Z_Calibrate(float z_min, float z_max);
+void I3G4250D_X_Calibrate(I3G4250D_HandleTypeDef *gyro, float x_min, float x_max);
+void I3G4250D_Y_Calibrate(I3G4250D_HandleTypeDef *gyro, float y_min, float y_max);
+void I3G4250D_Z_Calibrate(I3G4250D_HandleTypeDef *gyro, float z_min, float z_max);
+
+// Stationary auto-calibration
+/* NOTE:
+Blocking, the gyroscope must be kept still. Switches to the ultra ODR with the FIFO in stream mode, averages the first n_samples
+samples of whole FIFO drains in integer arithmetic and stores the result in X_Bias, Y_Bias and Z_Bias.
+The previous configuration is restored from the shadow registers afterwards. Must not be called while a DMA transfer is in progress.
+*/
+HAL_StatusTypeDef I3G4250D_AutoCalibrate(I3G4250D_HandleTypeDef *gyro, uint16_t n_samples);
+
+// Online bias estimation
+/* NOTE:
+Tracks the mean and variance of every axis with integer exponential filters, O(1) per sample.
+While the variance of all axes stays below varianceThreshold for minStillSamples samples the gyroscope is considered stationary
+and X_Bias, Y_Bias and Z_Bias are pulled towards the measured mean, once every minStillSamples samples.
+A perfectly constant rotation cannot be told apart from standing still by the variance alone, keep the threshold close to the sensor noise.
+Thresholds from 2047^2 digits^2 up, the largest variance tracked, count every sample as stationary.
+Once enabled the estimator runs on every sample delivered through the DMA completion path; feed polled samples with I3G4250D_BiasEstimatorUpdate.
+*/
+void I3G4250D_BiasEstimatorInit(I3G4250D_HandleTypeDef *gyro, uint32_t varianceThreshold, uint16_t minStillSamples);
+void I3G4250D_BiasEstimatorDisable(I3G4250D_HandleTypeDef *gyro);
+void I3G4250D_BiasEstimatorUpdate(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *samples, size_t n);
+bool I3G4250D_IsStationary(I3G4250D_HandleTypeDef *gyro);
+
+// Wake-on-motion
+/* NOTE:
+I3G4250D_ConfigureWakeup sets the rate threshold in MDPS for the axes given by I3G4250D_WAKE_ (any of them wakes up, or all
+of them with andEvents) and how long the rate has to stay above it, in milliseconds at the sleep ODR of 100 HZ.
+I3G4250D_EnterSleep saves the streaming configuration, stops INT2, bypasses the FIFO, drops to I3G4250D_ODR_BW_LOW and
+enables the latched threshold interrupt on INT1, so neither the CPU nor the SPI bus does anything until real motion occurs.
+Call I3G4250D_INT1_IRQHandler from HAL_GPIO_EXTI_Callback for the INT1 pin (rising edge), it only marks the wakeup as pending.
+I3G4250D_WakeService then does the work from the main loop or a thread, like I3G4250D_AdaptiveOdrService: it clears the latch,
+restores the streaming configuration (restarting INT2 data ready reads), calls the wake callback and returns true
+(I3G4250D_Rtos_Service calls it itself). I3G4250D_Wake restores the configuration without an interrupt. These use blocking
+transfers and must not be called while a DMA transfer is in progress, I3G4250D_WakeService keeps the wakeup pending until then.
+*/
+HAL_StatusTypeDef I3G4250D_ConfigureWakeup(I3G4250D_HandleTypeDef *gyro, uint32_t thresholdMdps, uint8_t axes, uint16_t durationMs, bool andEvents);
+HAL_StatusTypeDef I3G4250D_EnterSleep(I3G4250D_HandleTypeDef *gyro);
+HAL_StatusTypeDef I3G4250D_Wake(I3G4250D_HandleTypeDef *gyro);
+bool I3G4250D_IsSleeping(I3G4250D_HandleTypeDef *gyro);
+void I3G4250D_RegisterWakeCallback(I3G4250D_HandleTypeDef *gyro, I3G4250D_WakeCallback callback);
+void I3G4250D_INT1_IRQHandler(I3G4250D_HandleTypeDef *gyro);
+bool I3G4250D_WakeService(I3G4250D_HandleTypeDef *gyro);
+
+// Decimation
+/* NOTE:
+I3G4250D_DecimatorInit inserts a CIC decimator of the given order (1 - 4) and ratio (2 - 32) into the DMA completion path,
+e.g. ratio 8 for 100 HZ out of I3G4250D_ODR_BW_ULTRA. The ring buffer and the data callback then only get every ratio-th, filtered
+sample, timestamped at the last input of its group, and the callback is skipped for transfers that complete no output, so the
+consumer wakes up ratio times less often and I3G4250D_RING_SIZE can shrink by the same factor. The bias estimator, the adaptive
+ODR and the block capture keep working on the full rate stream, blocking reads are not decimated.
+The filter is integer only, with a DC gain of exactly one. Its sinc^order response droops in the passband (about 0.9 dB per
+order at a quarter of the output rate) and suppresses aliasing better with a higher order. Order * log2(ratio) may not exceed
+16 bits of growth, e.g. order 4 allows ratios up to 16.
+*/
+HAL_StatusTypeDef I3G4250D_DecimatorInit(I3G4250D_HandleTypeDef *gyro, uint8_t ratio, uint8_t order);
+void I3G4250D_DecimatorDisable(I3G4250D_HandleTypeDef *gyro);
+uint32_t I3G4250D_DecimatorRate(I3G4250D_HandleTypeDef *gyro);
+
+// Temperature compensation
+/* NOTE:
+I3G4250D_TempCompInit extends every data burst by one byte to include OUT_TEMP: single sample reads then start at OUT_TEMP
+whatever axes are enabled, FIFO drains read OUT_TEMP and STATUS_REG once ahead of the samples. Whenever the temperature changes,
+the zero rate level is interpolated linearly from `table` (points entries sorted by temperature, held constant beyond both ends)
+and the change since the previous reading is added to X_Bias, Y_Bias and Z_Bias, followed by I3G4250D_UpdateGain. The scaling
+functions and block kernels therefore run unchanged, and a bias found by I3G4250D_AutoCalibrate or the bias estimator is kept
+and moved along the table. With table NULL only the temperature is tracked.
+OUT_TEMP has a resolution of 1 degree and an untrimmed offset (I3G4250D_TEMP_OFFSET): measure the table with
+I3G4250D_GetTemperature on the same part, e.g. at -20, 0, 25, 50 and 70 degrees, so the offset error cancels.
+The table is referenced, not copied. Must not be called while a DMA transfer is in progress.
+*/
+void I3G4250D_TempCompInit(I3G4250D_HandleTypeDef *gyro, const I3G4250D_TempBiasTypeDef *table, uint8_t points);
+void I3G4250D_TempCompDisable(I3G4250D_HandleTypeDef *gyro);
+int8_t I3G4250D_GetTemperature(I3G4250D_HandleTypeDef *gyro);
+
+// Adaptive output data rate
+/* NOTE:
+Switches CTRL_REG1 to highPreset as soon as any axis of a sample exceeds thresholdMdps (bias corrected) and back to lowPreset
+once quietMs passed without such a sample, e.g. I3G4250D_ODR_BW_LOW and I3G4250D_ODR_BW_ULTRA. Only the ODR/bandwidth bits
+of CTRL_REG1 are rewritten through the shadow cache, the sample period used for timestamps follows automatically
+and the sensitivity is not affected. Samples still stored in the FIFO at a switch are stamped with the new period.
+Once enabled it runs on every sample delivered through the DMA completion path. The interrupt only decides on a switch,
+the 2 byte register write is a blocking transfer and is left to I3G4250D_AdaptiveOdrService: call it from the main loop or
+a thread, it returns true when it switched (I3G4250D_Rtos_Service calls it itself). Feed polled samples with
+I3G4250D_AdaptiveOdrUpdate, which decides and writes in one call.
+*/
+void I3G4250D_AdaptiveOdrInit(I3G4250D_HandleTypeDef *gyro, uint8_t lowPreset, uint8_t highPreset, uint32_t thresholdMdps, uint32_t quietMs);
+void I3G4250D_AdaptiveOdrDisable(I3G4250D_HandleTypeDef *gyro);
+bool I3G4250D_AdaptiveOdrUpdate(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *samples, size_t n);
+bool I3G4250D_AdaptiveOdrService(I3G4250D_HandleTypeDef *gyro);
+
+#ifdef I3G4250D_ENABLE_STATS
+// Instrumentation
+/* NOTE:
+Only compiled in when I3G4250D_ENABLE_STATS is defined, otherwise the hot paths carry no extra code.
+Transaction durations are measured with I3G4250D_GetTimestamp, i.e. in CPU cycles with the default DWT timestamp source.
+The counters are updated from the DMA completion interrupt as well, I3G4250D_GetStats copies them without locking,
+so a snapshot taken while a transfer completes may mix old and new values.
+*/
+void I3G4250D_GetStats(I3G4250D_HandleTypeDef *gyro, I3G4250D_StatsTypeDef *stats);
+void I3G4250D_ResetStats(I3G4250D_HandleTypeDef *gyro);
+uint32_t I3G4250D_StatsAverageCycles(const I3G4250D_TransactionStatsTypeDef *transactions);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,233 @@
+/*
+Library: Accelerometer - I3G4250D
+Written by: Fatih Ertikin
+Date: 02/10/2020
+Description: Header only C++ variant of the I3G4250D driver for a fixed bus, chip select, full scale and set of enabled axes.
+References:
+    1) I3G4250D Datasheet:
+    https://www.st.com/resource/en/datasheet/i3g4250d.pdf
+
+* Copyright (C) 2020 - F. Ertikin
+   This is a free software under the GNU license, you can redistribute it and/or modify it under the terms
+   of the GNU General Public Licenseversion 3 as published by the Free Software Foundation.
+
+   This software library is shared with puplic for educational purposes, without WARRANTY and Author is not liable for any damages caused directly
+   or indirectly by this software, read more about this on the GNU General Public License.
+*/
+
+#ifndef I3G4250D_HPP
+#define I3G4250D_HPP
+
+#include "I3G4250D.h"
+#include <stdint.h>
+
+/* NOTE:
+I3G4250D<SpiBus, CsPin, FullScale, Axes> fixes the configuration that does not change per product at compile time:
+the register values, the sensitivity and the burst length are constexpr, so there is no runtime branch on the full scale
+and scaling folds into one multiply-add per enabled axis. Only the span of output registers covering the enabled axes is read,
+disabled axes read as 0. Requires C++17.
+
+SpiBus provides static HAL_StatusTypeDef Transfer(uint8_t *frame, uint16_t size), a full-duplex in-place transfer like
+I3G4250D_TransferIO, and CsPin provides static void Write(bool level). I3G4250D_HalSpi and I3G4250D_HalPin implement both
+on top of I3G4250D_Port.h, e.g.
+
+    extern SPI_HandleTypeDef hspi5;
+    I3G4250D<I3G4250D_HalSpi<&hspi5>, I3G4250D_HalPin<GPIOC_BASE, GPIO_PIN_1>, I3G4250D_SCALE_500, I3G4250D_ENABLE_Z> gyro;
+*/
+
+// SPI bus policy on a HAL SPI handle with static storage
+template <SPI_HandleTypeDef *Handle>
+struct I3G4250D_HalSpi
+{
+    static HAL_StatusTypeDef Transfer(uint8_t *frame, uint16_t size)
+    {
+        return I3G4250D_BUS_TRANSFER(Handle, frame, frame, size, 10);
+    }
+};
+
+// Chip select policy on a GPIO port given by its base address
+template <uintptr_t PortAddress, uint16_t Pin>
+struct I3G4250D_HalPin
+{
+    static void Write(bool level)
+    {
+        I3G4250D_CS_WRITE(reinterpret_cast<GPIO_TypeDef *>(PortAddress), Pin, level ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    }
+};
+
+template <typename SpiBus, typename CsPin, uint8_t FullScale, uint8_t Axes = I3G4250D_ENABLE_ALL_AXIS>
+class I3G4250D
+{
+    static_assert(FullScale == I3G4250D_SCALE_245 || FullScale == I3G4250D_SCALE_500 || FullScale == I3G4250D_SCALE_2000 || FullScale == I3G4250D_SCALE_2000_2,
+                  "FullScale must be one of the I3G4250D_SCALE_ selections");
+    static_assert((Axes & 0xF0) == 0 && (Axes & 0x08) && (Axes & 0x07), "Axes must be a combination of the I3G4250D_ENABLE_ presets");
+
+public:
+    static constexpr bool HasX = (Axes & 0x01) != 0;
+    static constexpr bool HasY = (Axes & 0x02) != 0;
+    static constexpr bool HasZ = (Axes & 0x04) != 0;
+
+    // MDPS/digit (See referenced datasheet table 4.)
+    static constexpr float Sensitivity = (FullScale == I3G4250D_SCALE_245) ? (float)I3G4250D_SENSITIVTY_8_75
+                                       : (FullScale == I3G4250D_SCALE_500) ? (float)I3G4250D_SENSITIVTY_17_50
+                                       : (float)I3G4250D_SENSITIVTY_70;
+    // MDPS/digit in Q16.16
+    static constexpr int32_t SensitivityQ16 = (int32_t)((Sensitivity * 65536.0f) + 0.5f);
+
+    // Constant register values
+    static constexpr uint8_t Ctrl4 = (uint8_t)((FullScale >> 2) & 0x30);
+    static constexpr uint8_t Ctrl1(uint8_t odrBwPreset)
+    {
+        return (uint8_t)((Axes & 0x0F) | (odrBwPreset & 0xF0));
+    }
+    static constexpr uint8_t Ctrl2(uint8_t hpfMode, uint8_t hpcfMode)
+    {
+        return (uint8_t)(((hpfMode << 4) & 0x30) | ((hpcfMode >> 4) & 0x0F));
+    }
+
+    // Output registers read per sample: the span from the first to the last enabled axis
+    static constexpr uint8_t FirstAxis = HasX ? 0 : (HasY ? 1 : 2);
+    static constexpr uint8_t LastAxis = HasZ ? 2 : (HasY ? 1 : 0);
+    static constexpr uint16_t BurstSize = (uint16_t)(1 + (2 * (LastAxis - FirstAxis + 1)));
+
+    // Write CTRL_REG1..CTRL_REG5 in one burst, the FIFO stays in bypass mode
+    HAL_StatusTypeDef Init(uint8_t odrBwPreset = I3G4250D_ODR_BW_ULTRA, uint8_t hpfMode = I3G4250D_HPF_MODE_NORMAL, uint8_t hpcfMode = I3G4250D_HPCF_MODE_1)
+    {
+        uint8_t frame[6] = {(uint8_t)(I3G4250D_CTRL_REG1 | I3G4250D_SPI_AUTO_INCREMENT), Ctrl1(odrBwPreset), Ctrl2(hpfMode, hpcfMode), 0x00, Ctrl4, 0x00};
+
+        CsPin::Write(true);
+        return Transfer(frame, sizeof(frame));
+    }
+
+    HAL_StatusTypeDef WriteRegister(uint8_t registerAddress, uint8_t value)
+    {
+        uint8_t frame[2] = {registerAddress, value};
+
+        return Transfer(frame, sizeof(frame));
+    }
+
+    uint8_t ReadRegister(uint8_t registerAddress)
+    {
+        uint8_t frame[2] = {(uint8_t)(registerAddress | I3G4250D_SPI_READ), 0x00};
+
+        Transfer(frame, sizeof(frame));
+        return frame[1];
+    }
+
+    bool DataReady()
+    {
+        constexpr uint8_t dataAvailable = (HasX ? I3G4250D_STATUS_XDA : 0) | (HasY ? I3G4250D_STATUS_YDA : 0) | (HasZ ? I3G4250D_STATUS_ZDA : 0);
+
+        return (ReadRegister(I3G4250D_STATUS_ADDR) & dataAvailable) != 0;
+    }
+
+    I3G4250D_DataRaw GetRawData()
+    {
+        uint8_t frame[BurstSize] = {(uint8_t)((I3G4250D_OUT_X_L_ADDR + (2 * FirstAxis)) | I3G4250D_SPI_READ | I3G4250D_SPI_AUTO_INCREMENT)};
+        I3G4250D_DataRaw raw = {0, 0, 0};
+
+        Transfer(frame, BurstSize);
+        if constexpr (HasX)
+        {
+            raw.x = Decode(frame, 0);
+        }
+        if constexpr (HasY)
+        {
+            raw.y = Decode(frame, 1);
+        }
+        if constexpr (HasZ)
+        {
+            raw.z = Decode(frame, 2);
+        }
+        return raw;
+    }
+
+    I3G4250D_DataScaled Scale(const I3G4250D_DataRaw &raw) const
+    {
+        I3G4250D_DataScaled scaled = {0.0f, 0.0f, 0.0f};
+
+        if constexpr (HasX)
+        {
+            scaled.x = ((float)raw.x * Sensitivity) - bias[0];
+        }
+        if constexpr (HasY)
+        {
+            scaled.y = ((float)raw.y * Sensitivity) - bias[1];
+        }
+        if constexpr (HasZ)
+        {
+            scaled.z = ((float)raw.z * Sensitivity) - bias[2];
+        }
+        return scaled;
+    }
+
+    I3G4250D_DataFixed ScaleFixed(const I3G4250D_DataRaw &raw) const
+    {
+        I3G4250D_DataFixed fixed = {0, 0, 0};
+
+        if constexpr (HasX)
+        {
+            fixed.x = (int32_t)(((int64_t)raw.x * SensitivityQ16) >> 16) - biasFixed[0];
+        }
+        if constexpr (HasY)
+        {
+            fixed.y = (int32_t)(((int64_t)raw.y * SensitivityQ16) >> 16) - biasFixed[1];
+        }
+        if constexpr (HasZ)
+        {
+            fixed.z = (int32_t)(((int64_t)raw.z * SensitivityQ16) >> 16) - biasFixed[2];
+        }
+        return fixed;
+    }
+
+    I3G4250D_DataScaled GetScaledData()
+    {
+        return Scale(GetRawData());
+    }
+
+    I3G4250D_DataFixed GetFixedData()
+    {
+        return ScaleFixed(GetRawData());
+    }
+
+    // Zero rate offset in MDPS
+    void SetBias(float x, float y, float z)
+    {
+        bias[0] = x;
+        bias[1] = y;
+        bias[2] = z;
+        biasFixed[0] = ToFixed(x);
+        biasFixed[1] = ToFixed(y);
+        biasFixed[2] = ToFixed(z);
+    }
+
+private:
+    float bias[3] = {0.0f, 0.0f, 0.0f};
+    int32_t biasFixed[3] = {0, 0, 0};
+
+    static HAL_StatusTypeDef Transfer(uint8_t *frame, uint16_t size)
+    {
+        HAL_StatusTypeDef status;
+
+        CsPin::Write(false);
+        status = SpiBus::Transfer(frame, size);
+        CsPin::Write(true);
+        return status;
+    }
+
+    // Rounded to the nearest MDPS like I3G4250D_UpdateGain does for the C offsets
+    static int32_t ToFixed(float value)
+    {
+        return (int32_t)(value >= 0.0f ? value + 0.5f : value - 0.5f);
+    }
+
+    // Axis `axis` of a burst that started at the first enabled axis
+    static int16_t Decode(const uint8_t *frame, uint8_t axis)
+    {
+        const uint8_t *data = &frame[1 + (2 * (axis - FirstAxis))];
+
+        return (int16_t)((data[1] << 8) | data[0]);
+    }
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*
+Library: Accelerometer - I3G4250D
+Written by: Fatih Ertikin
+Date: 02/10/2020
+Description: Orientation tracking for the I3G4250D driver, integrates timestamped gyroscope samples into a unit quaternion.
+References:
+    1) I3G4250D Datasheet:
+    https://www.st.com/resource/en/datasheet/i3g4250d.pdf
+
+* Copyright (C) 2020 - F. Ertikin
+   This is a free software under the GNU license, you can redistribute it and/or modify it under the terms
+   of the GNU General Public Licenseversion 3 as published by the Free Software Foundation.
+	
+   This software library is shared with puplic for educational purposes, without WARRANTY and Author is not liable for any damages caused directly
+   or indirectly by this software, read more about this on the GNU General Public License.
+*/
+
+#include "I3G4250D_Attitude.h"
+
+#define _I3G4250D_PI 3.14159265358979f
+
+// Largest rate in MDPS the fixed-point update has to handle without overflowing, 2^22 is above the 2000 DPS range
+#define _I3G4250D_MAX_MDPS_LOG2 22
+
+// Fast inverse square root, two Newton iterations keep the quaternion norm within 1e-5 of one
+static float I3G4250D_InvSqrt(float x)
+{
+    float half = 0.5f * x;
+    uint32_t bits;
+
+    memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5F3759DF - (bits >> 1);
+    memcpy(&x, &bits, sizeof(x));
+    x = x * (1.5f - (half * x * x));
+    x = x * (1.5f - (half * x * x));
+    return x;
+}
+
+// Time since the previous sample in timestamp ticks, 0 for the first sample and after a gap
+static uint32_t I3G4250D_AttitudeDt(uint32_t *lastTimestamp, bool *started, uint32_t maxDt, uint32_t timestamp)
+{
+    uint32_t dt = timestamp - *lastTimestamp;
+
+    *lastTimestamp = timestamp;
+    if (!*started)
+    {
+        *started = true;
+        return 0;
+    }
+    return dt <= maxDt ? dt : 0;
+}
+
+void I3G4250D_AttitudeInit(I3G4250D_AttitudeTypeDef *attitude, uint32_t timestampFrequency)
+{
+    attitude->radPerMdpsTick = _I3G4250D_PI / (180000.0f * (float)timestampFrequency);
+    attitude->maxDt = (uint32_t)(((uint64_t)timestampFrequency * I3G4250D_ATTITUDE_MAX_DT_MS) / 1000);
+    I3G4250D_AttitudeReset(attitude);
+}
+
+void I3G4250D_AttitudeReset(I3G4250D_AttitudeTypeDef *attitude)
+{
+    attitude->q0 = 1.0f;
+    attitude->q1 = 0.0f;
+    attitude->q2 = 0.0f;
+    attitude->q3 = 0.0f;
+    attitude->started = false;
+}
+
+void I3G4250D_AttitudeUpdate(I3G4250D_AttitudeTypeDef *attitude, I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataStamped *samples, size_t n)
+{
+    float q0 = attitude->q0, q1 = attitude->q1, q2 = attitude->q2, q3 = attitude->q3;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        uint32_t dt = I3G4250D_AttitudeDt(&attitude->lastTimestamp, &attitude->started, attitude->maxDt, samples[i].timestamp);
+        if (dt == 0)
+        {
+            continue;
+        }
+
+        // Half of the rotation angle around each axis during dt
+        I3G4250D_DataScaled rate = I3G4250D_ConvertScaled(gyro, &samples[i].data);
+        float halfAngle = 0.5f * attitude->radPerMdpsTick * (float)dt;
+        float hx = rate.x * halfAngle;
+        float hy = rate.y * halfAngle;
+        float hz = rate.z * halfAngle;
+
+        float n0 = q0 - (q1 * hx) - (q2 * hy) - (q3 * hz);
+        float n1 = q1 + (q0 * hx) + (q2 * hz) - (q3 * hy);
+        float n2 = q2 + (q0 * hy) - (q1 * hz) + (q3 * hx);
+        float n3 = q3 + (q0 * hz) + (q1 * hy) - (q2 * hx);
+
+        float invNorm = I3G4250D_InvSqrt((n0 * n0) + (n1 * n1) + (n2 * n2) + (n3 * n3));
+        q0 = n0 * invNorm;
+        q1 = n1 * invNorm;
+        q2 = n2 * invNorm;
+        q3 = n3 * invNorm;
+    }
+
+    attitude->q0 = q0;
+    attitude->q1 = q1;
+    attitude->q2 = q2;
+    attitude->q3 = q3;
+}
+
+void I3G4250D_AttitudeFixedInit(I3G4250D_AttitudeFixedTypeDef *attitude, uint32_t timestampFrequency)
+{
+    // pi / (180000 * 2 * f) radians per MDPS tick as a Q2.30 half angle, with as many extra bits as the
+    // largest MDPS * dt product allows. Only done once, so the soft-float math here does not matter.
+    double scale = (3.14159265358979 * 1073741824.0) / (360000.0 * (double)timestampFrequency);
+    double limit;
+
+    attitude->maxDt = (uint32_t)(((uint64_t)timestampFrequency * I3G4250D_ATTITUDE_MAX_DT_MS) / 1000);
+    if (attitude->maxDt == 0)
+    {
+        attitude->maxDt = 1;
+    }
+    limit = 4611686018427387904.0 / ((double)(1UL << _I3G4250D_MAX_MDPS_LOG2) * (double)attitude->maxDt);
+    attitude->halfAngleShift = 0;
+    while ((scale * 2.0) < limit && attitude->halfAngleShift < 62)
+    {
+        scale *= 2.0;
+        attitude->halfAngleShift++;
+    }
+    attitude->halfAngleScale = (int64_t)(scale + 0.5);
+    I3G4250D_AttitudeFixedReset(attitude);
+}
+
+void I3G4250D_AttitudeFixedReset(I3G4250D_AttitudeFixedTypeDef *attitude)
+{
+    attitude->q0 = I3G4250D_ATTITUDE_Q30_ONE;
+    attitude->q1 = 0;
+    attitude->q2 = 0;
+    attitude->q3 = 0;
+    attitude->started = false;
+}
+
+// Q2.30 multiply
+static int32_t I3G4250D_MulQ30(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+void I3G4250D_AttitudeFixedUpdate(I3G4250D_AttitudeFixedTypeDef *attitude, I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataStamped *samples, size_t n)
+{
+    int32_t q0 = attitude->q0, q1 = attitude->q1, q2 = attitude->q2, q3 = attitude->q3;
+    int64_t scale = attitude->halfAngleScale;
+    uint8_t shift = attitude->halfAngleShift;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        uint32_t dt = I3G4250D_AttitudeDt(&attitude->lastTimestamp, &attitude->started, attitude->maxDt, samples[i].timestamp);
+        if (dt == 0)
+        {
+            continue;
+        }
+
+        // Half of the rotation angle around each axis during dt in Q2.30
+        I3G4250D_DataFixed rate = I3G4250D_ConvertFixed(gyro, &samples[i].data);
+        int32_t hx = (int32_t)((((int64_t)rate.x * dt) * scale) >> shift);
+        int32_t hy = (int32_t)((((int64_t)rate.y * dt) * scale) >> shift);
+        int32_t hz = (int32_t)((((int64_t)rate.z * dt) * scale) >> shift);
+
+        int32_t n0 = q0 - I3G4250D_MulQ30(q1, hx) - I3G4250D_MulQ30(q2, hy) - I3G4250D_MulQ30(q3, hz);
+        int32_t n1 = q1 + I3G4250D_MulQ30(q0, hx) + I3G4250D_MulQ30(q2, hz) - I3G4250D_MulQ30(q3, hy);
+        int32_t n2 = q2 + I3G4250D_MulQ30(q0, hy) - I3G4250D_MulQ30(q1, hz) + I3G4250D_MulQ30(q3, hx);
+        int32_t n3 = q3 + I3G4250D_MulQ30(q0, hz) + I3G4250D_MulQ30(q1, hy) - I3G4250D_MulQ30(q2, hx);
+
+        // The norm stays close to one, so a single Newton step of the inverse square root seeded with 1 is enough
+        int32_t norm = I3G4250D_MulQ30(n0, n0) + I3G4250D_MulQ30(n1, n1) + I3G4250D_MulQ30(n2, n2) + I3G4250D_MulQ30(n3, n3);
+        int32_t invNorm = (int32_t)(((3 * (int64_t)I3G4250D_ATTITUDE_Q30_ONE) - norm) >> 1);
+        q0 = I3G4250D_MulQ30(n0, invNorm);
+        q1 = I3G4250D_MulQ30(n1, invNorm);
+        q2 = I3G4250D_MulQ30(n2, invNorm);
+        q3 = I3G4250D_MulQ30(n3, invNorm);
+    }
+
+    attitude->q0 = q0;
+    attitude->q1 = q1;
+    attitude->q2 = q2;
+    attitude->q3 = q3;
+}
@@ -0,0 +1,80 @@
+/*
+Library: Accelerometer - I3G4250D
+Written by: Fatih Ertikin
+Date: 02/10/2020
+Description: Orientation tracking for the I3G4250D driver, integrates timestamped gyroscope samples into a unit quaternion.
+References:
+    1) I3G4250D Datasheet:
+    https://www.st.com/resource/en/datasheet/i3g4250d.pdf
+
+* Copyright (C) 2020 - F. Ertikin
+   This is a free software under the GNU license, you can redistribute it and/or modify it under the terms
+   of the GNU General Public Licenseversion 3 as published by the Free Software Foundation.
+	
+   This software library is shared with puplic for educational purposes, without WARRANTY and Author is not liable for any damages caused directly
+   or indirectly by this software, read more about this on the GNU General Public License.
+*/
+
+#ifndef I3G4250D_ATTITUDE_H
+#define I3G4250D_ATTITUDE_H
+
+#include "I3G4250D.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* NOTE:
+The quaternion is advanced with the first order update q += 0.5 * q * w * dt for every sample, using the time between
+consecutive sample timestamps as dt, and renormalized afterwards. Gaps longer than I3G4250D_ATTITUDE_MAX_DT_MS are skipped.
+The float variant renormalizes with a fast inverse square root, the fixed-point variant keeps the quaternion in Q2.30
+and uses only integer math for cores without an FPU. Both use the gain and bias of the gyroscope handle.
+*/
+#ifndef I3G4250D_ATTITUDE_MAX_DT_MS
+#define I3G4250D_ATTITUDE_MAX_DT_MS      100
+#endif
+
+#define I3G4250D_ATTITUDE_Q30_ONE        ((int32_t)1 << 30)
+
+//Typedefs
+typedef struct
+{
+    float q0;                                                   // Scalar part
+    float q1;
+    float q2;
+    float q3;
+    float radPerMdpsTick;                                       // Converts MDPS * timestamp ticks to radians
+    uint32_t maxDt;                                             // In timestamp ticks
+    uint32_t lastTimestamp;
+    bool started;
+} I3G4250D_AttitudeTypeDef;
+
+typedef struct
+{
+    int32_t q0;                                                 // Q2.30, scalar part
+    int32_t q1;
+    int32_t q2;
+    int32_t q3;
+    int64_t halfAngleScale;                                     // Converts MDPS * timestamp ticks to half angles in Q2.30, shifted left by halfAngleShift
+    uint8_t halfAngleShift;
+    uint32_t maxDt;                                             // In timestamp ticks
+    uint32_t lastTimestamp;
+    bool started;
+} I3G4250D_AttitudeFixedTypeDef;
+
+// Function prototypes
+// Float
+void I3G4250D_AttitudeInit(I3G4250D_AttitudeTypeDef *attitude, uint32_t timestampFrequency);
+void I3G4250D_AttitudeReset(I3G4250D_AttitudeTypeDef *attitude);
+void I3G4250D_AttitudeUpdate(I3G4250D_AttitudeTypeDef *attitude, I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataStamped *samples, size_t n);
+
+// Fixed-point
+void I3G4250D_AttitudeFixedInit(I3G4250D_AttitudeFixedTypeDef *attitude, uint32_t timestampFrequency);
+void I3G4250D_AttitudeFixedReset(I3G4250D_AttitudeFixedTypeDef *attitude);
+void I3G4250D_AttitudeFixedUpdate(I3G4250D_AttitudeFixedTypeDef *attitude, I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataStamped *samples, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,99 @@
+/*
+Library: Accelerometer - I3G4250D
+Written by: Fatih Ertikin
+Date: 02/10/2020
+Description: Register level SPI and chip select backend of the I3G4250D driver, bypasses the HAL SPI and GPIO functions.
+References:
+    1) I3G4250D Datasheet:
+    https://www.st.com/resource/en/datasheet/i3g4250d.pdf
+    2) RM0090 STM32F4 Reference manual, 28.3.5 Data transmission and reception procedures:
+    https://www.st.com/resource/en/reference_manual/dm00031020.pdf
+
+* Copyright (C) 2020 - F. Ertikin
+   This is a free software under the GNU license, you can redistribute it and/or modify it under the terms
+   of the GNU General Public Licenseversion 3 as published by the Free Software Foundation.
+
+   This software library is shared with puplic for educational purposes, without WARRANTY and Author is not liable for any damages caused directly
+   or indirectly by this software, read more about this on the GNU General Public License.
+*/
+
+#ifndef I3G4250D_LL_H
+#define I3G4250D_LL_H
+
+#ifdef I3G4250D_HOST
+#error "The register level backend needs the SPI peripheral, it is not available in the host build"
+#endif
+
+/* NOTE:
+Included by I3G4250D_Port.h when I3G4250D_LL is defined. The blocking transfers then write SPI_DR and poll SPI_SR directly
+and the chip select goes through GPIO_BSRR, without the state checks, locking and tick based timeouts of the HAL, so
+I3G4250D_ReadIO, I3G4250D_WriteIO and I3G4250D_TransferIO are cheap enough to call from an interrupt. DMA transfers
+still use the HAL, HAL_SPI_Init must have configured the bus (8-bit, full-duplex master) before the first transfer.
+The timeout is a number of polls per byte instead of milliseconds, so it also works with the tick interrupt masked.
+*/
+
+#ifndef I3G4250D_LL_SPIN_LIMIT
+#define I3G4250D_LL_SPIN_LIMIT           10000U                // Status polls per byte before HAL_TIMEOUT
+#endif
+
+// Full-duplex transfer of `size` bytes, tx may be NULL to send zeros, rx may be NULL to discard, both may point to the same buffer
+static inline HAL_StatusTypeDef I3G4250D_LL_Transfer(SPI_HandleTypeDef *hspi, const uint8_t *tx, uint8_t *rx, uint16_t size)
+{
+    SPI_TypeDef *spi = hspi->Instance;
+    uint16_t sent = 0;
+    uint16_t received = 0;
+    uint32_t spins = 0;
+
+    if ((spi->CR1 & SPI_CR1_SPE) == 0)
+    {
+        spi->CR1 |= SPI_CR1_SPE;
+    }
+    // Drop a byte left over from a previous transmit only transfer, reading DR then SR also clears OVR
+    while (spi->SR & (SPI_SR_RXNE | SPI_SR_OVR))
+    {
+        (void)spi->DR;
+        (void)spi->SR;
+    }
+
+    // Keep the transmit buffer filled while the previous byte shifts, at most two bytes in flight so RXNE can never overrun.
+    // In place transfers are safe, byte `sent` is always loaded before byte `received` < `sent` is stored.
+    while (received < size)
+    {
+        uint32_t status = spi->SR;
+
+        if (sent < size && (status & SPI_SR_TXE) && (uint16_t)(sent - received) < 2)
+        {
+            *(volatile uint8_t *)&spi->DR = tx != NULL ? tx[sent] : 0x00;
+            sent++;
+            spins = 0;
+        }
+        if (status & SPI_SR_RXNE)
+        {
+            uint8_t value = *(volatile uint8_t *)&spi->DR;
+            if (rx != NULL)
+            {
+                rx[received] = value;
+            }
+            received++;
+            spins = 0;
+        }
+        else if (++spins > I3G4250D_LL_SPIN_LIMIT)
+        {
+            return HAL_TIMEOUT;
+        }
+    }
+    return HAL_OK;
+}
+
+static inline void I3G4250D_LL_CsWrite(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    // The upper half of BSRR resets, the lower half sets, both in one atomic store
+    port->BSRR = (state == GPIO_PIN_RESET) ? ((uint32_t)pin << 16) : (uint32_t)pin;
+}
+
+#define I3G4250D_BUS_TRANSMIT(bus, data, size, timeout)          ((void)(timeout), I3G4250D_LL_Transfer((bus), (data), NULL, (size)))
+#define I3G4250D_BUS_RECEIVE(bus, data, size, timeout)           ((void)(timeout), I3G4250D_LL_Transfer((bus), NULL, (data), (size)))
+#define I3G4250D_BUS_TRANSFER(bus, tx, rx, size, timeout)        ((void)(timeout), I3G4250D_LL_Transfer((bus), (tx), (rx), (size)))
+#define I3G4250D_CS_WRITE(port, pin, state)                      I3G4250D_LL_CsWrite((port), (pin), (state))
+
+#endif
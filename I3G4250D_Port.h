@@ -0,0 +1,110 @@
+/*
+Library: Accelerometer - I3G4250D
+Written by: Fatih Ertikin
+Date: 02/10/2020
+Description: Bus and platform abstraction of the I3G4250D driver, maps the SPI, GPIO and tick calls of the driver to the STM32 HAL.
+References:
+    1) I3G4250D Datasheet:
+    https://www.st.com/resource/en/datasheet/i3g4250d.pdf
+
+* Copyright (C) 2020 - F. Ertikin
+   This is a free software under the GNU license, you can redistribute it and/or modify it under the terms
+   of the GNU General Public Licenseversion 3 as published by the Free Software Foundation.
+	
+   This software library is shared with puplic for educational purposes, without WARRANTY and Author is not liable for any damages caused directly
+   or indirectly by this software, read more about this on the GNU General Public License.
+*/
+
+#ifndef I3G4250D_PORT_H
+#define I3G4250D_PORT_H
+
+/* NOTE:
+The driver only talks to the hardware through the macros below. Each one can be defined before this header is included
+(e.g. on the compiler command line) to run the driver on another bus layer.
+Defining I3G4250D_HOST replaces the STM32 HAL with host/I3G4250D_Host.h, the simulated gyroscope used by the host build.
+Defining I3G4250D_LL replaces the blocking HAL SPI transfers and the chip select writes with the register level backend in I3G4250D_LL.h.
+Defining I3G4250D_RTOS maps the bus lock, completion, yield and delay hooks to the CMSIS-RTOS2 port in I3G4250D_Rtos.c.
+*/
+#ifdef I3G4250D_HOST
+#include "I3G4250D_Host.h"
+#else
+#include "stm32f4xx_hal.h"
+#endif
+
+#ifdef I3G4250D_LL
+#include "I3G4250D_LL.h"
+#endif
+
+#ifdef I3G4250D_RTOS
+#ifdef __cplusplus
+extern "C" {
+#endif
+HAL_StatusTypeDef I3G4250D_Rtos_BusLock(SPI_HandleTypeDef *bus);
+void I3G4250D_Rtos_BusUnlock(SPI_HandleTypeDef *bus);
+void I3G4250D_Rtos_BusComplete(SPI_HandleTypeDef *bus);
+void I3G4250D_Rtos_Yield(void);
+void I3G4250D_Rtos_Delay(uint32_t ms);
+#ifdef __cplusplus
+}
+#endif
+
+#define I3G4250D_BUS_LOCK(bus)                                   I3G4250D_Rtos_BusLock(bus)
+#define I3G4250D_BUS_UNLOCK(bus)                                 I3G4250D_Rtos_BusUnlock(bus)
+#define I3G4250D_BUS_COMPLETE(bus)                               I3G4250D_Rtos_BusComplete(bus)
+#define I3G4250D_YIELD()                                         I3G4250D_Rtos_Yield()
+#define I3G4250D_DELAY(ms)                                       I3G4250D_Rtos_Delay(ms)
+#endif
+
+// Blocking SPI transfers, return HAL_StatusTypeDef
+#ifndef I3G4250D_BUS_TRANSMIT
+#define I3G4250D_BUS_TRANSMIT(bus, data, size, timeout)          HAL_SPI_Transmit((bus), (data), (size), (timeout))
+#endif
+#ifndef I3G4250D_BUS_RECEIVE
+#define I3G4250D_BUS_RECEIVE(bus, data, size, timeout)           HAL_SPI_Receive((bus), (data), (size), (timeout))
+#endif
+#ifndef I3G4250D_BUS_TRANSFER
+#define I3G4250D_BUS_TRANSFER(bus, tx, rx, size, timeout)        HAL_SPI_TransmitReceive((bus), (tx), (rx), (size), (timeout))
+#endif
+
+// Non-blocking SPI transfer, completion is reported through I3G4250D_TxRxCpltHandler / I3G4250D_ErrorHandler
+#ifndef I3G4250D_BUS_TRANSFER_DMA
+#define I3G4250D_BUS_TRANSFER_DMA(bus, tx, rx, size)             HAL_SPI_TransmitReceive_DMA((bus), (tx), (rx), (size))
+#endif
+
+// Exclusive access to a shared bus around every blocking transaction, returns HAL_StatusTypeDef
+#ifndef I3G4250D_BUS_LOCK
+#define I3G4250D_BUS_LOCK(bus)                                   HAL_OK
+#endif
+#ifndef I3G4250D_BUS_UNLOCK
+#define I3G4250D_BUS_UNLOCK(bus)                                 ((void)0)
+#endif
+
+// Called at the end of every SPI DMA completion or error seen by the driver, including transfers of other devices on the bus
+#ifndef I3G4250D_BUS_COMPLETE
+#define I3G4250D_BUS_COMPLETE(bus)                               ((void)0)
+#endif
+
+// Reconfigure the bus to another SPI_BAUDRATEPRESCALER_ value, returns HAL_StatusTypeDef
+#ifndef I3G4250D_BUS_SET_PRESCALER
+#define I3G4250D_BUS_SET_PRESCALER(bus, prescaler)               ((bus)->Init.BaudRatePrescaler = (prescaler), HAL_SPI_Init(bus))
+#endif
+
+// Chip select output
+#ifndef I3G4250D_CS_WRITE
+#define I3G4250D_CS_WRITE(port, pin, state)                      HAL_GPIO_WritePin((port), (pin), (state))
+#endif
+
+// Millisecond tick and delay
+#ifndef I3G4250D_GET_TICK
+#define I3G4250D_GET_TICK()                                      HAL_GetTick()
+#endif
+#ifndef I3G4250D_DELAY
+#define I3G4250D_DELAY(ms)                                       HAL_Delay(ms)
+#endif
+
+// Called on every iteration of a wait loop, lets other tasks run
+#ifndef I3G4250D_YIELD
+#define I3G4250D_YIELD()                                         ((void)0)
+#endif
+
+#endif
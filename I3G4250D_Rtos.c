@@ -0,0 +1,278 @@
+/*
+Library: Accelerometer - I3G4250D
+Written by: Fatih Ertikin
+Date: 02/10/2020
+Description: Optional CMSIS-RTOS2 port of the I3G4250D driver: shared SPI bus arbitration and task notification based waiting.
+References:
+    1) I3G4250D Datasheet:
+    https://www.st.com/resource/en/datasheet/i3g4250d.pdf
+    2) CMSIS-RTOS2 API:
+    https://arm-software.github.io/CMSIS_5/RTOS2/html/index.html
+
+* Copyright (C) 2020 - F. Ertikin
+   This is a free software under the GNU license, you can redistribute it and/or modify it under the terms
+   of the GNU General Public Licenseversion 3 as published by the Free Software Foundation.
+
+   This software library is shared with puplic for educational purposes, without WARRANTY and Author is not liable for any damages caused directly
+   or indirectly by this software, read more about this on the GNU General Public License.
+*/
+
+#include "I3G4250D_Rtos.h"
+
+static I3G4250D_Rtos_BusTypeDef I3G4250D_Rtos_Buses[I3G4250D_RTOS_MAX_BUSES];
+
+static I3G4250D_Rtos_BusTypeDef *I3G4250D_Rtos_FindBus(SPI_HandleTypeDef *bus)
+{
+    for (uint8_t i = 0; i < I3G4250D_RTOS_MAX_BUSES; i++)
+    {
+        if (I3G4250D_Rtos_Buses[i].SPI_Handle == bus)
+        {
+            return &I3G4250D_Rtos_Buses[i];
+        }
+    }
+    return NULL;
+}
+
+// Before the scheduler starts there is only one thread and nothing to arbitrate
+static bool I3G4250D_Rtos_Running(void)
+{
+    return osKernelGetState() == osKernelRunning;
+}
+
+static bool I3G4250D_Rtos_InInterrupt(void)
+{
+    return __get_IPSR() != 0U;
+}
+
+static HAL_StatusTypeDef I3G4250D_Rtos_FlagsStatus(uint32_t flags)
+{
+    if (flags == (uint32_t)osFlagsErrorTimeout)
+    {
+        return HAL_TIMEOUT;
+    }
+    return (flags & osFlagsError) ? HAL_ERROR : HAL_OK;
+}
+
+static HAL_StatusTypeDef I3G4250D_Rtos_Acquire(I3G4250D_Rtos_BusTypeDef *shared, uint32_t timeout)
+{
+    if (shared == NULL || !I3G4250D_Rtos_Running())
+    {
+        return HAL_OK;
+    }
+    if (I3G4250D_Rtos_InInterrupt())
+    {
+        return HAL_BUSY;
+    }
+    if (osMutexAcquire(shared->mutex, timeout) != osOK)
+    {
+        return HAL_TIMEOUT;
+    }
+    // Recursive, the thread servicing a DMA read keeps the bus across the blocking transactions it makes
+    if (shared->depth++ == 0)
+    {
+        shared->owner = osThreadGetId();
+    }
+    return HAL_OK;
+}
+
+static void I3G4250D_Rtos_Release(I3G4250D_Rtos_BusTypeDef *shared)
+{
+    if (shared == NULL || !I3G4250D_Rtos_Running() || I3G4250D_Rtos_InInterrupt() || shared->depth == 0)
+    {
+        return;
+    }
+    if (--shared->depth == 0)
+    {
+        shared->owner = NULL;
+    }
+    osMutexRelease(shared->mutex);
+}
+
+HAL_StatusTypeDef I3G4250D_Rtos_BusInit(SPI_HandleTypeDef *bus)
+{
+    const osMutexAttr_t attributes = {"I3G4250D bus", osMutexRecursive | osMutexPrioInherit, NULL, 0};
+    I3G4250D_Rtos_BusTypeDef *shared = I3G4250D_Rtos_FindBus(bus);
+
+    if (shared != NULL)
+    {
+        return HAL_OK;
+    }
+    shared = I3G4250D_Rtos_FindBus(NULL);
+    if (shared == NULL)
+    {
+        return HAL_ERROR;
+    }
+    shared->mutex = osMutexNew(&attributes);
+    if (shared->mutex == NULL)
+    {
+        return HAL_ERROR;
+    }
+    shared->owner = NULL;
+    shared->depth = 0;
+    shared->SPI_Handle = bus;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef I3G4250D_Rtos_BusLock(SPI_HandleTypeDef *bus)
+{
+    return I3G4250D_Rtos_Acquire(I3G4250D_Rtos_FindBus(bus), I3G4250D_RTOS_LOCK_TIMEOUT);
+}
+
+void I3G4250D_Rtos_BusUnlock(SPI_HandleTypeDef *bus)
+{
+    I3G4250D_Rtos_Release(I3G4250D_Rtos_FindBus(bus));
+}
+
+void I3G4250D_Rtos_BusComplete(SPI_HandleTypeDef *bus)
+{
+    I3G4250D_Rtos_BusTypeDef *shared = I3G4250D_Rtos_FindBus(bus);
+    osThreadId_t owner;
+
+    if (shared == NULL)
+    {
+        return;
+    }
+    owner = shared->owner;
+    if (owner != NULL)
+    {
+        osThreadFlagsSet(owner, I3G4250D_RTOS_FLAG_DMA);
+    }
+}
+
+void I3G4250D_Rtos_Yield(void)
+{
+    // A thread yield would only let threads of the same priority run, sleep for a tick instead
+    if (I3G4250D_Rtos_Running() && !I3G4250D_Rtos_InInterrupt())
+    {
+        osDelay(1);
+    }
+}
+
+void I3G4250D_Rtos_Delay(uint32_t ms)
+{
+    uint32_t frequency;
+
+    if (!I3G4250D_Rtos_Running() || I3G4250D_Rtos_InInterrupt())
+    {
+        HAL_Delay(ms);
+        return;
+    }
+    // Round up to whole kernel ticks plus one, osDelay counts the tick that is already running
+    frequency = osKernelGetTickFreq();
+    osDelay((uint32_t)((((uint64_t)ms * frequency) + 999U) / 1000U) + 1U);
+}
+
+HAL_StatusTypeDef I3G4250D_Rtos_BusTransfer(I3G4250D_Rtos_ClientTypeDef *client, uint8_t *tx, uint8_t *rx, size_t size, uint32_t timeout)
+{
+    I3G4250D_Rtos_BusTypeDef *shared = I3G4250D_Rtos_FindBus(client->SPI_Handle);
+    size_t chunk = client->chunkSize > 0 ? client->chunkSize : 0xFFFF;
+    HAL_StatusTypeDef status = HAL_OK;
+
+    if (shared == NULL || !I3G4250D_Rtos_Running() || I3G4250D_Rtos_InInterrupt())
+    {
+        return HAL_ERROR;
+    }
+
+    for (size_t offset = 0; offset < size && status == HAL_OK; offset += chunk)
+    {
+        uint16_t length = (uint16_t)((size - offset) < chunk ? (size - offset) : chunk);
+
+        // Taking the bus again for every chunk lets a higher priority thread in between
+        status = I3G4250D_Rtos_Acquire(shared, timeout);
+        if (status != HAL_OK)
+        {
+            break;
+        }
+        osThreadFlagsClear(I3G4250D_RTOS_FLAG_DMA);
+        client->select(client->context, true, offset);
+        if (rx != NULL)
+        {
+            status = HAL_SPI_TransmitReceive_DMA(client->SPI_Handle, &tx[offset], &rx[offset], length);
+        }
+        else
+        {
+            status = HAL_SPI_Transmit_DMA(client->SPI_Handle, &tx[offset], length);
+        }
+        if (status == HAL_OK)
+        {
+            status = I3G4250D_Rtos_FlagsStatus(osThreadFlagsWait(I3G4250D_RTOS_FLAG_DMA, osFlagsWaitAny, timeout));
+            if (status != HAL_OK)
+            {
+                HAL_SPI_Abort(client->SPI_Handle);
+            }
+            else if (client->SPI_Handle->ErrorCode != HAL_SPI_ERROR_NONE)
+            {
+                status = HAL_ERROR;
+            }
+        }
+        client->select(client->context, false, offset);
+        I3G4250D_Rtos_Release(shared);
+    }
+    return status;
+}
+
+void I3G4250D_Rtos_Init(I3G4250D_RtosTypeDef *rtos, I3G4250D_HandleTypeDef *gyro)
+{
+    rtos->gyro = gyro;
+    rtos->thread = osThreadGetId();
+    rtos->drdyTimestamp = 0;
+}
+
+void I3G4250D_Rtos_INT1_IRQHandler(I3G4250D_RtosTypeDef *rtos)
+{
+    osThreadFlagsSet(rtos->thread, I3G4250D_RTOS_FLAG_INT1);
+}
+
+void I3G4250D_Rtos_INT2_IRQHandler(I3G4250D_RtosTypeDef *rtos)
+{
+    // The edge is timestamped here, the read itself may start a few ticks later
+    rtos->drdyTimestamp = I3G4250D_GetTimestamp();
+    osThreadFlagsSet(rtos->thread, I3G4250D_RTOS_FLAG_INT2);
+}
+
+HAL_StatusTypeDef I3G4250D_Rtos_Service(I3G4250D_RtosTypeDef *rtos, uint32_t timeout)
+{
+    I3G4250D_HandleTypeDef *gyro = rtos->gyro;
+    I3G4250D_Rtos_BusTypeDef *shared = I3G4250D_Rtos_FindBus(gyro->SPI_Handle);
+    uint32_t flags = osThreadFlagsWait(I3G4250D_RTOS_FLAG_INT1 | I3G4250D_RTOS_FLAG_INT2, osFlagsWaitAny, timeout);
+    HAL_StatusTypeDef status = I3G4250D_Rtos_FlagsStatus(flags);
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+    status = I3G4250D_Rtos_Acquire(shared, I3G4250D_RTOS_LOCK_TIMEOUT);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    //** 1. Start the reads while holding the bus, a wakeup restarts INT2 data ready reads itself **//
+    osThreadFlagsClear(I3G4250D_RTOS_FLAG_DMA);
+    if (flags & I3G4250D_RTOS_FLAG_INT1)
+    {
+        I3G4250D_INT1_IRQHandler(gyro);
+        I3G4250D_WakeService(gyro);
+    }
+    if ((flags & I3G4250D_RTOS_FLAG_INT2) && !I3G4250D_IsSleeping(gyro) && !I3G4250D_DMABusy(gyro))
+    {
+        I3G4250D_INT2_CaptureHandler(gyro, rtos->drdyTimestamp);
+    }
+
+    //** 2. Sleep until the completion interrupt, which may chain a read for an edge that arrived meanwhile **//
+    while (I3G4250D_DMABusy(gyro))
+    {
+        status = I3G4250D_Rtos_FlagsStatus(osThreadFlagsWait(I3G4250D_RTOS_FLAG_DMA, osFlagsWaitAny, timeout));
+        if (status != HAL_OK)
+        {
+            HAL_SPI_Abort(gyro->SPI_Handle);
+            I3G4250D_ErrorHandler(gyro->SPI_Handle);
+            break;
+        }
+    }
+
+    //** 3. Apply an ODR switch decided by the completion interrupt, still holding the bus **//
+    I3G4250D_AdaptiveOdrService(gyro);
+    I3G4250D_Rtos_Release(shared);
+    return status;
+}
@@ -0,0 +1,108 @@
+/*
+Library: Accelerometer - I3G4250D
+Written by: Fatih Ertikin
+Date: 02/10/2020
+Description: Optional CMSIS-RTOS2 port of the I3G4250D driver: shared SPI bus arbitration and task notification based waiting.
+References:
+    1) I3G4250D Datasheet:
+    https://www.st.com/resource/en/datasheet/i3g4250d.pdf
+    2) CMSIS-RTOS2 API:
+    https://arm-software.github.io/CMSIS_5/RTOS2/html/index.html
+
+* Copyright (C) 2020 - F. Ertikin
+   This is a free software under the GNU license, you can redistribute it and/or modify it under the terms
+   of the GNU General Public Licenseversion 3 as published by the Free Software Foundation.
+
+   This software library is shared with puplic for educational purposes, without WARRANTY and Author is not liable for any damages caused directly
+   or indirectly by this software, read more about this on the GNU General Public License.
+*/
+
+#ifndef I3G4250D_RTOS_H
+#define I3G4250D_RTOS_H
+
+#include "I3G4250D.h"
+#include "cmsis_os2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* NOTE:
+Build the driver with I3G4250D_RTOS defined and add I3G4250D_Rtos.c (FreeRTOS through the CMSIS-RTOS2 wrapper, or any
+other CMSIS-RTOS2 kernel).
+
+Shared bus: I3G4250D_Rtos_BusInit registers an SPI bus with a recursive, priority inheriting mutex. Every blocking driver
+transaction then holds it, and CMSIS-RTOS2 (like FreeRTOS) hands a released mutex to the highest priority waiting thread.
+The other devices on the bus (e.g. the LCD on SPI5 of the STM32F429I-DISC1) use I3G4250D_Rtos_BusTransfer, which splits a long
+DMA transfer into chunks of chunkSize bytes and releases the bus between them, so a gyroscope read waits for at most one chunk
+instead of a whole framebuffer. The select callback asserts and releases the chip select of the client around every chunk and
+can resend a continuation command (e.g. ILI9341 memory write continue) when offset is not 0.
+Route HAL_SPI_TxCpltCallback and HAL_SPI_ErrorCallback of clients that are not the gyroscope to I3G4250D_Rtos_BusComplete,
+I3G4250D_TxRxCpltHandler and I3G4250D_ErrorHandler already call it for every transfer.
+Unregistered buses are not locked. Blocking driver calls must be made from threads, from an interrupt the lock fails with HAL_BUSY.
+
+Task notification: I3G4250D_Rtos_Init binds a gyroscope to the calling thread. Call I3G4250D_Rtos_INT2_IRQHandler and
+I3G4250D_Rtos_INT1_IRQHandler from HAL_GPIO_EXTI_Callback instead of the driver handlers. They only capture the timestamp and
+set a thread flag. I3G4250D_Rtos_Service, called in the loop of that thread, sleeps until an edge arrives, then runs the DMA
+read (or the wakeup of I3G4250D_WakeService) while holding the bus and sleeps again until the completion interrupt,
+so the thread never polls. Samples end up in the ring buffer and the data callback as usual. The thread flags
+I3G4250D_RTOS_FLAG_ are reserved on that thread.
+*/
+
+#ifndef I3G4250D_RTOS_MAX_BUSES
+#define I3G4250D_RTOS_MAX_BUSES          2
+#endif
+#ifndef I3G4250D_RTOS_LOCK_TIMEOUT
+#define I3G4250D_RTOS_LOCK_TIMEOUT       100                   // Kernel ticks a blocking driver transaction waits for the bus
+#endif
+
+// Thread flags
+#ifndef I3G4250D_RTOS_FLAG_BASE
+#define I3G4250D_RTOS_FLAG_BASE          0x00010000U
+#endif
+#define I3G4250D_RTOS_FLAG_DMA           (I3G4250D_RTOS_FLAG_BASE << 0)
+#define I3G4250D_RTOS_FLAG_INT2          (I3G4250D_RTOS_FLAG_BASE << 1)
+#define I3G4250D_RTOS_FLAG_INT1          (I3G4250D_RTOS_FLAG_BASE << 2)
+
+// Shared SPI bus
+typedef struct
+{
+    SPI_HandleTypeDef *SPI_Handle;
+    osMutexId_t mutex;
+    volatile osThreadId_t owner;                                // Thread holding the bus, notified on DMA completion
+    uint16_t depth;
+} I3G4250D_Rtos_BusTypeDef;
+
+// Chip select of a bus client, `active` around every chunk of I3G4250D_Rtos_BusTransfer starting at `offset` bytes
+typedef void (*I3G4250D_Rtos_SelectCallback)(void *context, bool active, size_t offset);
+
+// Another device on a shared bus
+typedef struct
+{
+    SPI_HandleTypeDef *SPI_Handle;
+    uint16_t chunkSize;                                         // Bytes per bus grant, 0 for the whole transfer
+    I3G4250D_Rtos_SelectCallback select;
+    void *context;
+} I3G4250D_Rtos_ClientTypeDef;
+
+// Gyroscope serviced by one thread
+typedef struct
+{
+    I3G4250D_HandleTypeDef *gyro;
+    osThreadId_t thread;
+    volatile uint32_t drdyTimestamp;
+} I3G4250D_RtosTypeDef;
+
+HAL_StatusTypeDef I3G4250D_Rtos_BusInit(SPI_HandleTypeDef *bus);
+HAL_StatusTypeDef I3G4250D_Rtos_BusTransfer(I3G4250D_Rtos_ClientTypeDef *client, uint8_t *tx, uint8_t *rx, size_t size, uint32_t timeout);
+
+void I3G4250D_Rtos_Init(I3G4250D_RtosTypeDef *rtos, I3G4250D_HandleTypeDef *gyro);
+void I3G4250D_Rtos_INT1_IRQHandler(I3G4250D_RtosTypeDef *rtos);
+void I3G4250D_Rtos_INT2_IRQHandler(I3G4250D_RtosTypeDef *rtos);
+HAL_StatusTypeDef I3G4250D_Rtos_Service(I3G4250D_RtosTypeDef *rtos, uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,369 @@
+/*
+Library: Accelerometer - I3G4250D
+Written by: Fatih Ertikin
+Date: 02/10/2020
+Description: Compact binary telemetry packets of raw I3G4250D samples, with a matching stream decoder for the host.
+References:
+    1) I3G4250D Datasheet:
+    https://www.st.com/resource/en/datasheet/i3g4250d.pdf
+
+* Copyright (C) 2020 - F. Ertikin
+   This is a free software under the GNU license, you can redistribute it and/or modify it under the terms
+   of the GNU General Public Licenseversion 3 as published by the Free Software Foundation.
+
+   This software library is shared with puplic for educational purposes, without WARRANTY and Author is not liable for any damages caused directly
+   or indirectly by this software, read more about this on the GNU General Public License.
+*/
+
+#include "I3G4250D_Telemetry.h"
+
+// Sequence, count, timestamp, a one byte period, the first sample, the widths and no deltas
+#define I3G4250D_TELEMETRY_LENGTH_MIN    (2 + 1 + 4 + 1 + 6 + 2)
+#define I3G4250D_TELEMETRY_LENGTH_MAX    (I3G4250D_TELEMETRY_PACKET_MAX - 4 - 2)
+
+// CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF), a nibble at a time from a 16 entry table
+static uint16_t I3G4250D_TelemetryCrc(const uint8_t *data, size_t size)
+{
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    };
+    uint16_t crc = 0xFFFF;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+static uint8_t *I3G4250D_TelemetryPutVarint(uint8_t *out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+    return out;
+}
+
+static uint8_t *I3G4250D_TelemetryPutU16(uint8_t *out, uint16_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    return out + 2;
+}
+
+// Small differences of either sign map to small codes: 0, -1, 1, -2, ... become 0, 1, 2, 3, ...
+static uint16_t I3G4250D_TelemetryZigZag(int16_t previous, int16_t current)
+{
+    uint16_t delta = (uint16_t)((uint16_t)current - (uint16_t)previous);
+
+    return (uint16_t)((delta << 1) ^ (uint16_t)(0U - (delta >> 15)));
+}
+
+static int16_t I3G4250D_TelemetryUnZigZag(int16_t previous, uint16_t code)
+{
+    uint16_t delta = (uint16_t)((code >> 1) ^ (uint16_t)(0U - (code & 1U)));
+
+    return (int16_t)(uint16_t)((uint16_t)previous + delta);
+}
+
+// Bits of a width code, 15 stands for a full 16 bit code
+static uint8_t I3G4250D_TelemetryWidth(uint8_t code)
+{
+    return code == 15 ? 16 : code;
+}
+
+// Smallest width code that holds every bit set in `codes`
+static uint8_t I3G4250D_TelemetryWidthCode(uint16_t codes)
+{
+    uint8_t bits = 0;
+
+    while (bits < 16 && (codes >> bits) != 0)
+    {
+        bits++;
+    }
+    return bits > 14 ? 15 : bits;
+}
+
+// Little endian bit stream, at most 7 + 16 bits are pending in `value`
+typedef struct
+{
+    uint8_t *out;
+    uint32_t value;
+    uint8_t bits;
+} I3G4250D_TelemetryBitWriter;
+
+static void I3G4250D_TelemetryPutBits(I3G4250D_TelemetryBitWriter *writer, uint16_t code, uint8_t width)
+{
+    writer->value |= (uint32_t)code << writer->bits;
+    writer->bits = (uint8_t)(writer->bits + width);
+    while (writer->bits >= 8)
+    {
+        *writer->out++ = (uint8_t)writer->value;
+        writer->value >>= 8;
+        writer->bits = (uint8_t)(writer->bits - 8);
+    }
+}
+
+//** Encoder **//
+
+void I3G4250D_TelemetryEncoderInit(I3G4250D_TelemetryEncoderTypeDef *encoder)
+{
+    encoder->busy[0] = false;
+    encoder->busy[1] = false;
+    encoder->next = 0;
+    encoder->sequence = 0;
+    encoder->dropped = 0;
+}
+
+// Returns the packet size and its buffer in `packet`, 0 when n is out of range or both buffers are still being sent
+size_t I3G4250D_TelemetryEncode(I3G4250D_TelemetryEncoderTypeDef *encoder, const I3G4250D_DataRaw *samples, size_t n, uint32_t timestamp, uint32_t period, const uint8_t **packet)
+{
+    uint8_t index = encoder->next;
+    uint8_t *start;
+    uint8_t *out;
+    uint16_t length;
+    uint16_t codes[3] = {0, 0, 0};
+    uint8_t widthCode[3];
+    uint8_t width[3];
+    I3G4250D_TelemetryBitWriter writer;
+
+    *packet = NULL;
+    if (n == 0 || n > I3G4250D_TELEMETRY_MAX_SAMPLES)
+    {
+        return 0;
+    }
+    if (encoder->busy[index])
+    {
+        index ^= 1;
+        if (encoder->busy[index])
+        {
+            encoder->dropped += (uint32_t)n;
+            return 0;
+        }
+    }
+    start = encoder->buffers[index];
+
+    //** 1. Header, the length is filled in at the end **//
+    out = start;
+    *out++ = I3G4250D_TELEMETRY_SYNC_1;
+    *out++ = I3G4250D_TELEMETRY_SYNC_2;
+    out += 2;
+    out = I3G4250D_TelemetryPutU16(out, encoder->sequence);
+    *out++ = (uint8_t)n;
+    out = I3G4250D_TelemetryPutU16(out, (uint16_t)timestamp);
+    out = I3G4250D_TelemetryPutU16(out, (uint16_t)(timestamp >> 16));
+    out = I3G4250D_TelemetryPutVarint(out, period);
+
+    //** 2. First sample verbatim and the bit width of every axis over the block **//
+    out = I3G4250D_TelemetryPutU16(out, (uint16_t)samples[0].x);
+    out = I3G4250D_TelemetryPutU16(out, (uint16_t)samples[0].y);
+    out = I3G4250D_TelemetryPutU16(out, (uint16_t)samples[0].z);
+    for (size_t i = 1; i < n; i++)
+    {
+        codes[0] |= I3G4250D_TelemetryZigZag(samples[i - 1].x, samples[i].x);
+        codes[1] |= I3G4250D_TelemetryZigZag(samples[i - 1].y, samples[i].y);
+        codes[2] |= I3G4250D_TelemetryZigZag(samples[i - 1].z, samples[i].z);
+    }
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        widthCode[axis] = I3G4250D_TelemetryWidthCode(codes[axis]);
+        width[axis] = I3G4250D_TelemetryWidth(widthCode[axis]);
+    }
+    *out++ = (uint8_t)(widthCode[0] | (widthCode[1] << 4));
+    *out++ = widthCode[2];
+
+    //** 3. The differences at those widths **//
+    writer.out = out;
+    writer.value = 0;
+    writer.bits = 0;
+    for (size_t i = 1; i < n; i++)
+    {
+        I3G4250D_TelemetryPutBits(&writer, I3G4250D_TelemetryZigZag(samples[i - 1].x, samples[i].x), width[0]);
+        I3G4250D_TelemetryPutBits(&writer, I3G4250D_TelemetryZigZag(samples[i - 1].y, samples[i].y), width[1]);
+        I3G4250D_TelemetryPutBits(&writer, I3G4250D_TelemetryZigZag(samples[i - 1].z, samples[i].z), width[2]);
+    }
+    I3G4250D_TelemetryPutBits(&writer, 0, (uint8_t)((8 - writer.bits) & 7));
+    out = writer.out;
+
+    //** 4. Length and CRC over everything after it **//
+    length = (uint16_t)(out - start - 4);
+    I3G4250D_TelemetryPutU16(start + 2, length);
+    out = I3G4250D_TelemetryPutU16(out, I3G4250D_TelemetryCrc(start + 4, length));
+
+    encoder->busy[index] = true;
+    encoder->next = index ^ 1;
+    encoder->sequence++;
+    *packet = start;
+    return (size_t)(out - start);
+}
+
+// Safe to call from the transfer complete interrupt, a pointer that is not one of the buffers is ignored
+void I3G4250D_TelemetryRelease(I3G4250D_TelemetryEncoderTypeDef *encoder, const uint8_t *packet)
+{
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        if (packet == encoder->buffers[i])
+        {
+            encoder->busy[i] = false;
+        }
+    }
+}
+
+//** Decoder **//
+
+static bool I3G4250D_TelemetryGetVarint(const uint8_t **in, const uint8_t *end, uint32_t *value)
+{
+    uint32_t result = 0;
+
+    for (uint8_t shift = 0; shift < 35 && *in < end; shift += 7)
+    {
+        uint8_t byte = *(*in)++;
+
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint16_t I3G4250D_TelemetryGetU16(const uint8_t *in)
+{
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+// Parses the bytes after the length field, false when they do not describe exactly one packet
+static bool I3G4250D_TelemetryParse(const uint8_t *in, size_t length, I3G4250D_TelemetryPacketTypeDef *packet)
+{
+    const uint8_t *end = in + length;
+    uint8_t width[3];
+    uint32_t value = 0;
+    uint8_t bits = 0;
+
+    packet->sequence = I3G4250D_TelemetryGetU16(in);
+    packet->count = in[2];
+    packet->timestamp = (uint32_t)I3G4250D_TelemetryGetU16(in + 3) | ((uint32_t)I3G4250D_TelemetryGetU16(in + 5) << 16);
+    in += 7;
+    if (packet->count == 0 || packet->count > I3G4250D_TELEMETRY_MAX_SAMPLES
+        || !I3G4250D_TelemetryGetVarint(&in, end, &packet->period))
+    {
+        return false;
+    }
+
+    if (end - in < 8)
+    {
+        return false;
+    }
+    packet->samples[0].x = (int16_t)I3G4250D_TelemetryGetU16(in);
+    packet->samples[0].y = (int16_t)I3G4250D_TelemetryGetU16(in + 2);
+    packet->samples[0].z = (int16_t)I3G4250D_TelemetryGetU16(in + 4);
+    width[0] = I3G4250D_TelemetryWidth(in[6] & 0x0F);
+    width[1] = I3G4250D_TelemetryWidth(in[6] >> 4);
+    width[2] = I3G4250D_TelemetryWidth(in[7] & 0x0F);
+    in += 8;
+    // The bit stream has to fill the rest of the packet exactly
+    if ((size_t)(end - in) != ((packet->count - 1) * (size_t)(width[0] + width[1] + width[2]) + 7) / 8)
+    {
+        return false;
+    }
+
+    for (size_t i = 1; i < packet->count; i++)
+    {
+        uint16_t code[3];
+
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            while (bits < width[axis])
+            {
+                value |= (uint32_t)*in++ << bits;
+                bits = (uint8_t)(bits + 8);
+            }
+            code[axis] = (uint16_t)(value & ((1UL << width[axis]) - 1U));
+            value >>= width[axis];
+            bits = (uint8_t)(bits - width[axis]);
+        }
+        packet->samples[i].x = I3G4250D_TelemetryUnZigZag(packet->samples[i - 1].x, code[0]);
+        packet->samples[i].y = I3G4250D_TelemetryUnZigZag(packet->samples[i - 1].y, code[1]);
+        packet->samples[i].z = I3G4250D_TelemetryUnZigZag(packet->samples[i - 1].z, code[2]);
+    }
+    return true;
+}
+
+static void I3G4250D_TelemetryDiscard(I3G4250D_TelemetryDecoderTypeDef *decoder, size_t n)
+{
+    decoder->length -= n;
+    memmove(decoder->frame, &decoder->frame[n], decoder->length);
+}
+
+void I3G4250D_TelemetryDecoderInit(I3G4250D_TelemetryDecoderTypeDef *decoder)
+{
+    decoder->length = 0;
+    decoder->started = false;
+    decoder->nextSequence = 0;
+    decoder->packets = 0;
+    decoder->crcErrors = 0;
+    decoder->lostPackets = 0;
+}
+
+bool I3G4250D_TelemetryDecodeByte(I3G4250D_TelemetryDecoderTypeDef *decoder, uint8_t byte, I3G4250D_TelemetryPacketTypeDef *packet)
+{
+    decoder->frame[decoder->length++] = byte;
+
+    // After a rejected frame the search for the next sync restarts one byte after the old one, inside the buffered bytes
+    while (decoder->length > 0)
+    {
+        uint8_t *frame = decoder->frame;
+        uint16_t length;
+        size_t total;
+
+        //** 1. Hunt for the sync word **//
+        if (frame[0] != I3G4250D_TELEMETRY_SYNC_1 || (decoder->length >= 2 && frame[1] != I3G4250D_TELEMETRY_SYNC_2))
+        {
+            I3G4250D_TelemetryDiscard(decoder, 1);
+            continue;
+        }
+        if (decoder->length < 4)
+        {
+            return false;
+        }
+
+        //** 2. Wait for the whole frame, a length no encoder can produce is a corrupted header **//
+        length = I3G4250D_TelemetryGetU16(&frame[2]);
+        if (length < I3G4250D_TELEMETRY_LENGTH_MIN || length > I3G4250D_TELEMETRY_LENGTH_MAX)
+        {
+            decoder->crcErrors++;
+            I3G4250D_TelemetryDiscard(decoder, 1);
+            continue;
+        }
+        total = 4U + length + 2U;
+        if (decoder->length < total)
+        {
+            return false;
+        }
+
+        //** 3. Check and unpack **//
+        if (I3G4250D_TelemetryCrc(&frame[4], length) == I3G4250D_TelemetryGetU16(&frame[4 + length])
+            && I3G4250D_TelemetryParse(&frame[4], length, packet))
+        {
+            if (decoder->started)
+            {
+                decoder->lostPackets += (uint16_t)(packet->sequence - decoder->nextSequence);
+            }
+            decoder->started = true;
+            decoder->nextSequence = (uint16_t)(packet->sequence + 1);
+            decoder->packets++;
+            I3G4250D_TelemetryDiscard(decoder, total);
+            return true;
+        }
+        decoder->crcErrors++;
+        I3G4250D_TelemetryDiscard(decoder, 1);
+    }
+    return false;
+}
@@ -0,0 +1,106 @@
+/*
+Library: Accelerometer - I3G4250D
+Written by: Fatih Ertikin
+Date: 02/10/2020
+Description: Compact binary telemetry packets of raw I3G4250D samples, with a matching stream decoder for the host.
+References:
+    1) I3G4250D Datasheet:
+    https://www.st.com/resource/en/datasheet/i3g4250d.pdf
+
+* Copyright (C) 2020 - F. Ertikin
+   This is a free software under the GNU license, you can redistribute it and/or modify it under the terms
+   of the GNU General Public Licenseversion 3 as published by the Free Software Foundation.
+
+   This software library is shared with puplic for educational purposes, without WARRANTY and Author is not liable for any damages caused directly
+   or indirectly by this software, read more about this on the GNU General Public License.
+*/
+
+#ifndef I3G4250D_TELEMETRY_H
+#define I3G4250D_TELEMETRY_H
+
+#include "I3G4250D.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* NOTE:
+Packet layout, multi-byte fields little endian:
+
+    0xA5 0x5A | length (2) | sequence (2) | count (1) | timestamp (4) | period (varint) | first sample (3 x int16) |
+    widths (X | Y << 4, Z) | count - 1 bit packed deltas | CRC-16/CCITT-FALSE (2)
+
+length counts the bytes from sequence up to the CRC, the CRC covers the same bytes. timestamp is the first sample in
+I3G4250D_GetTimestamp ticks and period the ticks between samples (a varint of 1 to 5 bytes). Every following sample is stored
+per axis as the difference to the previous one (modulo 2^16, so any jump round trips), zig-zag mapped so small differences of
+either sign give small codes. Each axis gets the bit width of its largest code in the packet, width codes 0 - 14 are that
+many bits and 15 stands for 16 bits. The codes follow sample by sample in X, Y, Z order, least significant bit first,
+padded to a whole byte. A gyroscope at rest or turning smoothly needs 4 - 6 bits per axis, a 32 sample packet then takes
+70 - 90 bytes instead of the 192 of I3G4250D_DataRaw or ~650 as text.
+
+The encoder owns two packet buffers. I3G4250D_TelemetryEncode fills a free one and returns it for a UART/USB DMA transfer,
+I3G4250D_TelemetryRelease (e.g. from HAL_UART_TxCpltCallback) frees it again, so the next packet is encoded while the previous
+one is still being sent. Only one encode call may run at a time.
+
+I3G4250D_TelemetryDecodeByte is plain C without HAL calls for the host side: feed it the received bytes in order and it
+returns true whenever a packet passed the CRC, resynchronizing on the next 0xA5 0x5A after corrupted or lost bytes.
+host/I3G4250D_TelemetryDecode.c turns a captured stream into CSV.
+*/
+
+#ifndef I3G4250D_TELEMETRY_MAX_SAMPLES
+#define I3G4250D_TELEMETRY_MAX_SAMPLES   I3G4250D_FIFO_SIZE    // Samples per packet, at most 255
+#endif
+#if (I3G4250D_TELEMETRY_MAX_SAMPLES < 1) || (I3G4250D_TELEMETRY_MAX_SAMPLES > 255)
+#error "I3G4250D_TELEMETRY_MAX_SAMPLES must be between 1 and 255"
+#endif
+
+#define I3G4250D_TELEMETRY_SYNC_1        0xA5
+#define I3G4250D_TELEMETRY_SYNC_2        0x5A
+#define I3G4250D_TELEMETRY_HEADER_SIZE   11                    // Sync, length, sequence, count and timestamp
+#define I3G4250D_TELEMETRY_PACKET_MAX    (I3G4250D_TELEMETRY_HEADER_SIZE + 5 + 6 + 2 + ((I3G4250D_TELEMETRY_MAX_SAMPLES - 1) * 6) + 2)
+
+//Typedefs
+typedef struct
+{
+    __ALIGNED(4) uint8_t buffers[2][I3G4250D_TELEMETRY_PACKET_MAX];
+    volatile bool busy[2];                                      // Handed out and not released yet
+    uint8_t next;
+    uint16_t sequence;
+    volatile uint32_t dropped;                                  // Samples not encoded because both buffers were busy
+} I3G4250D_TelemetryEncoderTypeDef;
+
+typedef struct
+{
+    uint16_t sequence;
+    uint32_t timestamp;                                         // Of samples[0]
+    uint32_t period;
+    size_t count;
+    I3G4250D_DataRaw samples[I3G4250D_TELEMETRY_MAX_SAMPLES];
+} I3G4250D_TelemetryPacketTypeDef;
+
+typedef struct
+{
+    uint8_t frame[I3G4250D_TELEMETRY_PACKET_MAX];
+    size_t length;
+    bool started;                                               // A packet has been decoded, sequence gaps are counted from then on
+    uint16_t nextSequence;
+    uint32_t packets;
+    uint32_t crcErrors;                                         // Frames dropped for a bad CRC or an impossible length
+    uint32_t lostPackets;                                       // Gaps in the sequence numbers
+} I3G4250D_TelemetryDecoderTypeDef;
+
+// Function prototypes
+// Encoder
+void I3G4250D_TelemetryEncoderInit(I3G4250D_TelemetryEncoderTypeDef *encoder);
+size_t I3G4250D_TelemetryEncode(I3G4250D_TelemetryEncoderTypeDef *encoder, const I3G4250D_DataRaw *samples, size_t n, uint32_t timestamp, uint32_t period, const uint8_t **packet);
+void I3G4250D_TelemetryRelease(I3G4250D_TelemetryEncoderTypeDef *encoder, const uint8_t *packet);
+
+// Decoder
+void I3G4250D_TelemetryDecoderInit(I3G4250D_TelemetryDecoderTypeDef *decoder);
+bool I3G4250D_TelemetryDecodeByte(I3G4250D_TelemetryDecoderTypeDef *decoder, uint8_t byte, I3G4250D_TelemetryPacketTypeDef *packet);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
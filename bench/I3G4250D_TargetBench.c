@@ -0,0 +1,278 @@
+/*
+Library: Accelerometer - I3G4250D
+Written by: Fatih Ertikin
+Date: 02/10/2020
+Description: On-target microbenchmark of the I3G4250D driver paths, measured with the DWT cycle counter.
+References:
+    1) I3G4250D Datasheet:
+    https://www.st.com/resource/en/datasheet/i3g4250d.pdf
+
+* Copyright (C) 2020 - F. Ertikin
+   This is a free software under the GNU license, you can redistribute it and/or modify it under the terms
+   of the GNU General Public Licenseversion 3 as published by the Free Software Foundation.
+
+   This software library is shared with puplic for educational purposes, without WARRANTY and Author is not liable for any damages caused directly
+   or indirectly by this software, read more about this on the GNU General Public License.
+*/
+
+#include "I3G4250D_TargetBench.h"
+#include <stdio.h>
+#include <stdarg.h>
+
+typedef struct
+{
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t count;
+} I3G4250D_BenchResult;
+
+typedef struct
+{
+    const char *name;
+    void (*prepare)(void);                                      // Not measured, may be NULL
+    void (*run)(void);
+    uint32_t iterations;
+} I3G4250D_BenchPath;
+
+static I3G4250D_HandleTypeDef benchGyro;
+static I3G4250D_DataRaw benchRaw[I3G4250D_FIFO_SIZE];
+static I3G4250D_DataScaled benchScaled[I3G4250D_FIFO_SIZE];
+#ifndef I3G4250D_HOST
+static I3G4250D_DataFixed benchFixed[I3G4250D_FIFO_SIZE];
+static I3G4250D_DataRaw benchQ15[I3G4250D_FIFO_SIZE];
+#endif
+static volatile int32_t benchSink;
+
+__weak void I3G4250D_TargetBench_Write(const char *text)
+{
+#ifdef I3G4250D_HOST
+    fputs(text, stdout);
+#else
+    while (*text != '\0')
+    {
+        ITM_SendChar((uint32_t)*text++);
+    }
+#endif
+}
+
+static void I3G4250D_BenchPrint(const char *format, ...)
+{
+    char line[96];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    I3G4250D_TargetBench_Write(line);
+}
+
+static uint32_t I3G4250D_BenchCycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+static uint32_t I3G4250D_BenchNs(uint64_t cycles)
+{
+    return (uint32_t)((cycles * 1000000000ULL) / SystemCoreClock);
+}
+
+//** Paths **//
+
+static void I3G4250D_BenchGetRawData(void)
+{
+    benchRaw[0] = I3G4250D_GetRawData(&benchGyro);
+}
+
+static void I3G4250D_BenchGetScaledData(void)
+{
+    benchScaled[0] = I3G4250D_GetScaledData(&benchGyro);
+}
+
+// A single STATUS_REG poll, the timeout of 0 ends the wait loop after its first iteration
+static void I3G4250D_BenchDataReady(void)
+{
+    benchSink += I3G4250D_DataReady(&benchGyro, 0);
+}
+
+// Wait without polling until the FIFO is full, one sample time more than it takes to fill
+static void I3G4250D_BenchFillFifo(void)
+{
+    I3G4250D_ReadFifo(&benchGyro, benchRaw, I3G4250D_FIFO_SIZE);
+    HAL_Delay(((I3G4250D_FIFO_SIZE + 1) * 1000U) / I3G4250D_GetODR(&benchGyro) + 1U);
+}
+
+static void I3G4250D_BenchReadFifo(void)
+{
+    benchSink += (int32_t)I3G4250D_ReadFifo(&benchGyro, benchRaw, I3G4250D_FIFO_SIZE);
+}
+
+static void I3G4250D_BenchWaitDMA(void)
+{
+    uint32_t start = HAL_GetTick();
+
+    while (I3G4250D_DMABusy(&benchGyro) && HAL_GetTick() - start < 10U)
+    {
+    }
+}
+
+static void I3G4250D_BenchGetRawDataDMA(void)
+{
+    if (I3G4250D_GetRawDataDMA(&benchGyro) == HAL_OK)
+    {
+        I3G4250D_BenchWaitDMA();
+    }
+}
+
+static void I3G4250D_BenchReadFifoDMA(void)
+{
+    if (I3G4250D_ReadFifoDMA(&benchGyro, I3G4250D_FIFO_SIZE) == HAL_OK)
+    {
+        I3G4250D_BenchWaitDMA();
+    }
+}
+
+#ifndef I3G4250D_HOST
+// The simulated DWT only counts HAL calls and bus transfers, the kernels would read 0 cycles on the host
+static void I3G4250D_BenchConvertScaled(void)
+{
+    for (size_t i = 0; i < I3G4250D_FIFO_SIZE; i++)
+    {
+        benchScaled[i] = I3G4250D_ConvertScaled(&benchGyro, &benchRaw[i]);
+    }
+}
+
+static void I3G4250D_BenchScaleBlock(void)
+{
+    I3G4250D_ScaleBlock(&benchGyro, benchRaw, benchScaled, I3G4250D_FIFO_SIZE);
+}
+
+static void I3G4250D_BenchScaleBlockFixed(void)
+{
+    I3G4250D_ScaleBlockFixed(&benchGyro, benchRaw, benchFixed, I3G4250D_FIFO_SIZE);
+}
+
+static void I3G4250D_BenchScaleBlockQ15(void)
+{
+    I3G4250D_ScaleBlockQ15(&benchGyro, benchRaw, benchQ15, I3G4250D_FIFO_SIZE);
+}
+#endif
+
+//** Runner **//
+
+static I3G4250D_BenchResult I3G4250D_BenchMeasure(const I3G4250D_BenchPath *path)
+{
+    I3G4250D_BenchResult result = {UINT32_MAX, 0, 0, 0};
+
+    for (uint32_t i = 0; i < path->iterations; i++)
+    {
+        uint32_t start;
+        uint32_t cycles;
+
+        if (path->prepare != NULL)
+        {
+            path->prepare();
+        }
+        start = I3G4250D_BenchCycles();
+        path->run();
+        cycles = I3G4250D_BenchCycles() - start;
+
+        result.min = cycles < result.min ? cycles : result.min;
+        result.max = cycles > result.max ? cycles : result.max;
+        result.total += cycles;
+        result.count++;
+    }
+    return result;
+}
+
+static void I3G4250D_BenchReport(uint32_t odr, uint32_t spiKhz, const I3G4250D_BenchPath *path)
+{
+    I3G4250D_BenchResult result = I3G4250D_BenchMeasure(path);
+    uint64_t average = result.count ? result.total / result.count : 0;
+
+    I3G4250D_BenchPrint("%5lu %7lu  %-18s %8lu %8lu %8lu %9lu\r\n",
+                        (unsigned long)odr, (unsigned long)spiKhz, path->name,
+                        (unsigned long)result.min, (unsigned long)average, (unsigned long)result.max,
+                        (unsigned long)I3G4250D_BenchNs(average));
+}
+
+// SPI clock of a prescaler, SPI5 is on APB2 and BR[2:0] divides by 2^(BR+1)
+static uint32_t I3G4250D_BenchSpiKhz(uint32_t prescaler)
+{
+    return (HAL_RCC_GetPCLK2Freq() >> (((prescaler >> 3) & 0x07) + 1)) / 1000U;
+}
+
+void I3G4250D_TargetBench_Run(SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin)
+{
+    static const uint8_t presets[] = {I3G4250D_ODR_BW_LOW, I3G4250D_ODR_BW_MEDIUM, I3G4250D_ODR_BW_HIGH, I3G4250D_ODR_BW_ULTRA};
+    static const uint32_t prescalers[] = {I3G4250D_BENCH_PRESCALERS};
+    static const I3G4250D_BenchPath blocking[] = {
+        {"GetRawData", NULL, I3G4250D_BenchGetRawData, I3G4250D_BENCH_ITERATIONS},
+        {"GetScaledData", NULL, I3G4250D_BenchGetScaledData, I3G4250D_BENCH_ITERATIONS},
+        {"DataReady", NULL, I3G4250D_BenchDataReady, I3G4250D_BENCH_ITERATIONS},
+        {"GetRawDataDMA", NULL, I3G4250D_BenchGetRawDataDMA, I3G4250D_BENCH_ITERATIONS},
+    };
+    static const I3G4250D_BenchPath fifo[] = {
+        {"ReadFifo 32", I3G4250D_BenchFillFifo, I3G4250D_BenchReadFifo, I3G4250D_BENCH_FIFO_ITERATIONS},
+        {"ReadFifoDMA 32", I3G4250D_BenchFillFifo, I3G4250D_BenchReadFifoDMA, I3G4250D_BENCH_FIFO_ITERATIONS},
+    };
+#ifndef I3G4250D_HOST
+    static const I3G4250D_BenchPath kernels[] = {
+        {"ConvertScaled 32", NULL, I3G4250D_BenchConvertScaled, I3G4250D_BENCH_ITERATIONS},
+        {"ScaleBlock 32", NULL, I3G4250D_BenchScaleBlock, I3G4250D_BENCH_ITERATIONS},
+        {"ScaleBlockFixed 32", NULL, I3G4250D_BenchScaleBlockFixed, I3G4250D_BENCH_ITERATIONS},
+        {"ScaleBlockQ15 32", NULL, I3G4250D_BenchScaleBlockQ15, I3G4250D_BENCH_ITERATIONS},
+    };
+#endif
+    uint32_t savedPrescaler = hspi->Init.BaudRatePrescaler;
+    I3G4250D_InitTypeDef init = {0};
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    I3G4250D_BenchPrint("I3G4250D target benchmark, %lu MHz core, cycles per call\r\n\r\n", (unsigned long)(SystemCoreClock / 1000000U));
+    I3G4250D_BenchPrint("%5s %7s  %-18s %8s %8s %8s %9s\r\n", "odr", "spi_khz", "path", "min", "avg", "max", "avg_ns");
+
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.FIFO_WATERMARK = 0;
+    for (size_t p = 0; p < sizeof(prescalers) / sizeof(prescalers[0]); p++)
+    {
+        uint32_t spiKhz = I3G4250D_BenchSpiKhz(prescalers[p]);
+
+        hspi->Init.BaudRatePrescaler = prescalers[p];
+        HAL_SPI_Init(hspi);
+        for (size_t o = 0; o < sizeof(presets) / sizeof(presets[0]); o++)
+        {
+            init.ODR_BW_PRESET = presets[o];
+            init.FIFO_MODE = I3G4250D_FIFO_MODE_BYPASS;
+            I3G4250D_Init(&benchGyro, hspi, csPort, csPin, &init);
+            // Leave power down and let the output settle
+            HAL_Delay(50);
+            for (size_t i = 0; i < sizeof(blocking) / sizeof(blocking[0]); i++)
+            {
+                I3G4250D_BenchReport(I3G4250D_GetODR(&benchGyro), spiKhz, &blocking[i]);
+            }
+            I3G4250D_SetFifoMode(&benchGyro, I3G4250D_FIFO_MODE_STREAM, 0);
+            for (size_t i = 0; i < sizeof(fifo) / sizeof(fifo[0]); i++)
+            {
+                I3G4250D_BenchReport(I3G4250D_GetODR(&benchGyro), spiKhz, &fifo[i]);
+            }
+        }
+    }
+
+    // The kernels do not touch the bus, run them once on the last FIFO drain
+    I3G4250D_BenchPrint("\r\n");
+#ifndef I3G4250D_HOST
+    for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++)
+    {
+        I3G4250D_BenchReport(I3G4250D_GetODR(&benchGyro), 0, &kernels[i]);
+    }
+#else
+    I3G4250D_BenchPrint("Scaling kernels are target only, see make bench for their host throughput\r\n");
+#endif
+
+    hspi->Init.BaudRatePrescaler = savedPrescaler;
+    HAL_SPI_Init(hspi);
+    I3G4250D_SetFifoMode(&benchGyro, I3G4250D_FIFO_MODE_BYPASS, 0);
+}
@@ -0,0 +1,58 @@
+/*
+Library: Accelerometer - I3G4250D
+Written by: Fatih Ertikin
+Date: 02/10/2020
+Description: On-target microbenchmark of the I3G4250D driver paths, measured with the DWT cycle counter.
+References:
+    1) I3G4250D Datasheet:
+    https://www.st.com/resource/en/datasheet/i3g4250d.pdf
+
+* Copyright (C) 2020 - F. Ertikin
+   This is a free software under the GNU license, you can redistribute it and/or modify it under the terms
+   of the GNU General Public Licenseversion 3 as published by the Free Software Foundation.
+
+   This software library is shared with puplic for educational purposes, without WARRANTY and Author is not liable for any damages caused directly
+   or indirectly by this software, read more about this on the GNU General Public License.
+*/
+
+#ifndef I3G4250D_TARGET_BENCH_H
+#define I3G4250D_TARGET_BENCH_H
+
+#include "I3G4250D.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* NOTE:
+Add bench/I3G4250D_TargetBench.c to a firmware project for the STM32F429I-DISC1 (gyroscope on SPI5, CS on PC1) and call
+I3G4250D_TargetBench_Run after the HAL, clock, SPI and DMA initialization, with the HAL SPI callbacks routed to the driver
+(I3G4250D_USE_HAL_SPI_CALLBACKS). For every ODR preset and SPI prescaler it reconfigures the bus, reinitializes the gyroscope
+and prints the minimum, average and maximum cycles of every read path, followed by the block scaling kernels on FIFO sized
+blocks. DMA rows are the time from the start of the transfer to its completion callback. Interrupts stay enabled, compare
+the minimum columns between releases, the maximum columns include the SysTick and other interrupts. The host build skips
+the kernels, its simulated DWT only advances on HAL calls and bus transfers.
+
+The results go to SWO (ITM stimulus port 0). Override the weak I3G4250D_TargetBench_Write to print over a UART instead, e.g.
+with HAL_UART_Transmit. The prescalers are given by I3G4250D_BENCH_PRESCALERS, the default skips the ones that exceed the
+10 MHz SPI clock of the gyroscope at the 90 MHz APB2 clock of the board.
+*/
+
+#ifndef I3G4250D_BENCH_ITERATIONS
+#define I3G4250D_BENCH_ITERATIONS        64                    // Measurements per path
+#endif
+#ifndef I3G4250D_BENCH_FIFO_ITERATIONS
+#define I3G4250D_BENCH_FIFO_ITERATIONS   8                     // Full FIFO drains per path, each one waits for the FIFO to fill
+#endif
+#ifndef I3G4250D_BENCH_PRESCALERS
+#define I3G4250D_BENCH_PRESCALERS        SPI_BAUDRATEPRESCALER_16, SPI_BAUDRATEPRESCALER_32, SPI_BAUDRATEPRESCALER_64, SPI_BAUDRATEPRESCALER_128
+#endif
+
+void I3G4250D_TargetBench_Run(SPI_HandleTypeDef *hspi, GPIO_TypeDef *csPort, uint16_t csPin);
+void I3G4250D_TargetBench_Write(const char *text);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,226 @@
+/*
+Throughput benchmark of the I3G4250D driver on the simulated gyroscope.
+For every read mode it reports the delivered sample rate, the bus traffic and the CPU time per sample in simulated
+core cycles, followed by the host time of the conversion functions. Exits with a non-zero status when a read mode
+loses samples or falls below the output data rate, so it can run as a regression check.
+*/
+
+#include "I3G4250D.h"
+#include "I3G4250D_Sim.h"
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_SECONDS                    2
+#define BENCH_WATERMARK                  16
+#define BENCH_CONVERT_SAMPLES            (1U << 20)
+#define BENCH_MIN_RATE_PERCENT           95
+
+static SPI_HandleTypeDef benchSpi;
+static I3G4250D_HandleTypeDef benchGyro;
+static uint32_t benchDelivered;
+
+typedef struct
+{
+    const char *name;
+    uint8_t axes;
+    uint8_t fifoMode;
+    uint8_t drdyMode;
+    void (*loop)(void);
+} BenchMode;
+
+static void BenchInt2(void *context)
+{
+    I3G4250D_INT2_IRQHandler((I3G4250D_HandleTypeDef *)context);
+}
+
+static bool BenchElapsed(uint64_t start)
+{
+    return I3G4250D_Sim_Cycles() - start >= (uint64_t)BENCH_SECONDS * SystemCoreClock;
+}
+
+// Poll STATUS_REG and read every sample
+static void BenchLoopPolled(void)
+{
+    uint64_t start = I3G4250D_Sim_Cycles();
+
+    while (!BenchElapsed(start))
+    {
+        if (I3G4250D_DataReady(&benchGyro, 10))
+        {
+            I3G4250D_GetRawData(&benchGyro);
+            benchDelivered++;
+        }
+    }
+}
+
+// Sleep for about one watermark worth of samples, then drain the FIFO
+static void BenchLoopFifo(void)
+{
+    I3G4250D_DataRaw block[I3G4250D_FIFO_SIZE];
+    uint64_t start = I3G4250D_Sim_Cycles();
+    uint32_t sleep = (BENCH_WATERMARK * 1000U) / I3G4250D_GetODR(&benchGyro);
+
+    while (!BenchElapsed(start))
+    {
+        HAL_Delay(sleep);
+        benchDelivered += (uint32_t)I3G4250D_ReadFifo(&benchGyro, block, I3G4250D_FIFO_SIZE);
+    }
+}
+
+// Samples arrive through INT2 and DMA, the consumer only empties the ring
+static void BenchLoopRing(void)
+{
+    I3G4250D_DataRaw block[I3G4250D_RING_SIZE];
+    uint64_t start = I3G4250D_Sim_Cycles();
+
+    while (!BenchElapsed(start))
+    {
+        HAL_Delay(10);
+        benchDelivered += (uint32_t)I3G4250D_RingPopBlock(&benchGyro, block, I3G4250D_RING_SIZE);
+    }
+}
+
+static bool BenchRun(const BenchMode *mode)
+{
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_Sim_BusStats bus;
+    uint64_t cycles;
+    uint64_t idle;
+    uint32_t lost;
+    uint32_t expected;
+    bool pass;
+
+    I3G4250D_Sim_Reset();
+    I3G4250D_Sim_SetRate(10.0f, -20.0f, 100.0f);
+    benchSpi.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_16;
+
+    init.ENABLED_AXIS = mode->axes;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_ULTRA;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.FIFO_MODE = mode->fifoMode;
+    init.FIFO_WATERMARK = BENCH_WATERMARK;
+    init.DRDY_MODE = mode->drdyMode;
+    I3G4250D_Init(&benchGyro, &benchSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_Sim_SetInt2Handler(mode->drdyMode != I3G4250D_DRDY_POLLING ? BenchInt2 : NULL, &benchGyro);
+
+    // Let the first samples settle, then measure from a clean state
+    HAL_Delay(20);
+    benchGyro.ring.tail = benchGyro.ring.head;
+    benchDelivered = 0;
+    {
+        I3G4250D_Sim_BusStats start = I3G4250D_Sim_GetBusStats();
+        uint64_t startCycles = I3G4250D_Sim_Cycles();
+        uint64_t startIdle = I3G4250D_Sim_IdleCycles();
+        uint32_t startLost = I3G4250D_Sim_SamplesLost();
+        uint32_t startGenerated = I3G4250D_Sim_SamplesGenerated();
+
+        mode->loop();
+
+        bus = I3G4250D_Sim_GetBusStats();
+        bus.bytes -= start.bytes;
+        bus.transactions -= start.transactions;
+        bus.dmaTransfers -= start.dmaTransfers;
+        cycles = I3G4250D_Sim_Cycles() - startCycles;
+        idle = I3G4250D_Sim_IdleCycles() - startIdle;
+        lost = I3G4250D_Sim_SamplesLost() - startLost;
+        expected = I3G4250D_Sim_SamplesGenerated() - startGenerated;
+    }
+    I3G4250D_Sim_SetInt2Handler(NULL, NULL);
+
+    pass = lost == 0 && ((uint64_t)benchDelivered * 100U) >= ((uint64_t)expected * BENCH_MIN_RATE_PERCENT);
+    printf("%-10s %10.1f %10.2f %10.3f %10.0f %9.1f%% %6u  %s\n",
+           mode->name,
+           (double)benchDelivered * SystemCoreClock / (double)cycles,
+           benchDelivered ? (double)bus.bytes / benchDelivered : 0.0,
+           benchDelivered ? (double)bus.transactions / benchDelivered : 0.0,
+           benchDelivered ? (double)(cycles - idle) / benchDelivered : 0.0,
+           100.0 * (double)(cycles - idle) / (double)cycles,
+           lost,
+           pass ? "ok" : "FAIL");
+    return pass;
+}
+
+static double BenchNow(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
+
+// Host nanoseconds per sample of the conversion functions, on blocks of FIFO size
+static void BenchConvert(void)
+{
+    static I3G4250D_DataRaw raw[I3G4250D_FIFO_SIZE];
+    static I3G4250D_DataScaled scaled[I3G4250D_FIFO_SIZE];
+    static I3G4250D_DataFixed fixed[I3G4250D_FIFO_SIZE];
+    static I3G4250D_DataRaw q15[I3G4250D_FIFO_SIZE];
+    volatile int32_t sink = 0;
+    double start;
+
+    for (size_t i = 0; i < I3G4250D_FIFO_SIZE; i++)
+    {
+        raw[i].x = (int16_t)(i * 37);
+        raw[i].y = (int16_t)(-(int32_t)i * 91);
+        raw[i].z = (int16_t)(i * 1021);
+    }
+
+    printf("\n%-22s %10s\n", "conversion", "ns/sample");
+
+    start = BenchNow();
+    for (uint32_t n = 0; n < BENCH_CONVERT_SAMPLES; n++)
+    {
+        I3G4250D_DataScaled value = I3G4250D_ConvertScaled(&benchGyro, &raw[n & (I3G4250D_FIFO_SIZE - 1)]);
+        sink += (int32_t)value.z;
+    }
+    printf("%-22s %10.2f\n", "ConvertScaled", (BenchNow() - start) * 1e9 / BENCH_CONVERT_SAMPLES);
+
+    start = BenchNow();
+    for (uint32_t n = 0; n < BENCH_CONVERT_SAMPLES; n += I3G4250D_FIFO_SIZE)
+    {
+        I3G4250D_ScaleBlock(&benchGyro, raw, scaled, I3G4250D_FIFO_SIZE);
+        sink += (int32_t)scaled[n & (I3G4250D_FIFO_SIZE - 1)].z;
+    }
+    printf("%-22s %10.2f\n", "ScaleBlock", (BenchNow() - start) * 1e9 / BENCH_CONVERT_SAMPLES);
+
+    start = BenchNow();
+    for (uint32_t n = 0; n < BENCH_CONVERT_SAMPLES; n += I3G4250D_FIFO_SIZE)
+    {
+        I3G4250D_ScaleBlockFixed(&benchGyro, raw, fixed, I3G4250D_FIFO_SIZE);
+        sink += fixed[n & (I3G4250D_FIFO_SIZE - 1)].z;
+    }
+    printf("%-22s %10.2f\n", "ScaleBlockFixed", (BenchNow() - start) * 1e9 / BENCH_CONVERT_SAMPLES);
+
+    start = BenchNow();
+    for (uint32_t n = 0; n < BENCH_CONVERT_SAMPLES; n += I3G4250D_FIFO_SIZE)
+    {
+        I3G4250D_ScaleBlockQ15(&benchGyro, raw, q15, I3G4250D_FIFO_SIZE);
+        sink += q15[n & (I3G4250D_FIFO_SIZE - 1)].z;
+    }
+    printf("%-22s %10.2f\n", "ScaleBlockQ15", (BenchNow() - start) * 1e9 / BENCH_CONVERT_SAMPLES);
+    (void)sink;
+}
+
+int main(void)
+{
+    static const BenchMode modes[] = {
+        {"polled", I3G4250D_ENABLE_ALL_AXIS, I3G4250D_FIFO_MODE_BYPASS, I3G4250D_DRDY_POLLING, BenchLoopPolled},
+        {"fifo", I3G4250D_ENABLE_ALL_AXIS, I3G4250D_FIFO_MODE_STREAM, I3G4250D_DRDY_POLLING, BenchLoopFifo},
+        {"int2-drdy", I3G4250D_ENABLE_ALL_AXIS, I3G4250D_FIFO_MODE_BYPASS, I3G4250D_DRDY_INT2, BenchLoopRing},
+        {"int2-wtm", I3G4250D_ENABLE_ALL_AXIS, I3G4250D_FIFO_MODE_STREAM, I3G4250D_DRDY_INT2_WTM, BenchLoopRing},
+        {"drdy-z", I3G4250D_ENABLE_Z, I3G4250D_FIFO_MODE_BYPASS, I3G4250D_DRDY_INT2, BenchLoopRing},
+    };
+    bool pass = true;
+
+    printf("I3G4250D host benchmark, %u MHz core, ODR %u Hz, %u s per mode\n\n",
+           (unsigned)(SystemCoreClock / 1000000U), (unsigned)I3G4250D_ODR_HZ_DR_11, (unsigned)BENCH_SECONDS);
+    printf("%-10s %10s %10s %10s %10s %10s %6s\n", "mode", "samples/s", "bytes/smp", "txn/smp", "cycles/smp", "cpu", "lost");
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+    {
+        pass &= BenchRun(&modes[i]);
+    }
+
+    BenchConvert();
+
+    return pass ? 0 : 1;
+}
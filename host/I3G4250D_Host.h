@@ -0,0 +1,129 @@
+/*
+Host build shim for the I3G4250D driver.
+Provides the subset of the STM32F4 HAL and CMSIS-Core the driver uses, backed by the simulated gyroscope in I3G4250D_Sim.c.
+Selected by defining I3G4250D_HOST, see I3G4250D_Port.h.
+Only for benchmarking and testing the driver on a PC, see README.md.
+*/
+
+#ifndef I3G4250D_HOST_H
+#define I3G4250D_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __weak                           __attribute__((weak))
+#define __ALIGNED(x)                     __attribute__((aligned(x)))
+#define __DMB()                          __sync_synchronize()
+
+typedef enum
+{
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+// SPI
+typedef struct
+{
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+} SPI_TypeDef;
+
+typedef struct
+{
+    uint32_t BaudRatePrescaler;
+} SPI_InitTypeDef;
+
+typedef struct
+{
+    SPI_TypeDef *Instance;
+    SPI_InitTypeDef Init;
+} SPI_HandleTypeDef;
+
+#define SPI_BAUDRATEPRESCALER_2          0x00000000U
+#define SPI_BAUDRATEPRESCALER_4          0x00000008U
+#define SPI_BAUDRATEPRESCALER_8          0x00000010U
+#define SPI_BAUDRATEPRESCALER_16         0x00000018U
+#define SPI_BAUDRATEPRESCALER_32         0x00000020U
+#define SPI_BAUDRATEPRESCALER_64         0x00000028U
+#define SPI_BAUDRATEPRESCALER_128        0x00000030U
+#define SPI_BAUDRATEPRESCALER_256        0x00000038U
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size);
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi);
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi);
+
+// Defining I3G4250D_SIM_BUS_LOCK gives the driver the shared bus lock of the simulator: recursive, failing with HAL_BUSY
+// from interrupt handlers and DMA completions and while I3G4250D_Sim_HoldBus lets another client hold the bus
+#ifdef I3G4250D_SIM_BUS_LOCK
+HAL_StatusTypeDef I3G4250D_Sim_BusLock(SPI_HandleTypeDef *bus);
+void I3G4250D_Sim_BusUnlock(SPI_HandleTypeDef *bus);
+#define I3G4250D_BUS_LOCK(bus)           I3G4250D_Sim_BusLock(bus)
+#define I3G4250D_BUS_UNLOCK(bus)         I3G4250D_Sim_BusUnlock(bus)
+#endif
+
+// GPIO
+typedef struct
+{
+    volatile uint32_t BSRR;
+} GPIO_TypeDef;
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_0                       ((uint16_t)0x0001)
+#define GPIO_PIN_1                       ((uint16_t)0x0002)
+#define GPIO_PIN_2                       ((uint16_t)0x0004)
+#define GPIO_PIN_3                       ((uint16_t)0x0008)
+
+extern GPIO_TypeDef *const GPIOC;
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+
+// Time
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+extern uint32_t SystemCoreClock;
+
+// Data watchpoint and trace unit, CYCCNT follows the simulated core clock
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk           (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk       (1UL << 24)
+
+DWT_Type *I3G4250D_Sim_DWT(void);
+extern CoreDebug_Type I3G4250D_Sim_CoreDebug;
+#define DWT                              (I3G4250D_Sim_DWT())
+#define CoreDebug                        (&I3G4250D_Sim_CoreDebug)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,787 @@
+/*
+Simulated I3G4250D for the host build, see I3G4250D_Sim.h.
+*/
+
+#include "I3G4250D_Sim.h"
+#include <string.h>
+
+#define SIM_CORE_CLOCK                   180000000U
+#define SIM_PCLK1                        45000000U
+#define SIM_PCLK2                        90000000U
+#define SIM_FIFO_SIZE                    32
+#define SIM_GETTICK_CYCLES               20                    // CPU cycles charged for every HAL_GetTick call
+
+uint32_t SystemCoreClock = SIM_CORE_CLOCK;
+CoreDebug_Type I3G4250D_Sim_CoreDebug;
+
+static GPIO_TypeDef simGpioC;
+GPIO_TypeDef *const GPIOC = &simGpioC;
+
+typedef struct
+{
+    int16_t axis[3];
+} SimSample;
+
+static struct
+{
+    uint64_t cycles;
+    uint64_t idleCycles;
+    uint64_t nextSampleCycle;
+    DWT_Type dwt;
+
+    // Register file and output state
+    uint8_t regs[0x40];
+    SimSample output;
+    SimSample fifo[SIM_FIFO_SIZE];
+    uint8_t fifoHead;
+    uint8_t fifoCount;
+    bool fifoTriggered;
+
+    // SPI transaction state
+    bool selected;
+    bool expectAddress;
+    bool readTransfer;
+    bool autoIncrement;
+    uint8_t address;
+    SPI_HandleTypeDef *dmaHandle;
+    uint64_t dmaDoneCycle;
+    bool inTransfer;
+    uint8_t interruptDepth;                                     // Interrupt handlers and DMA completions being delivered
+
+    // Shared bus lock of I3G4250D_SIM_BUS_LOCK
+    bool busHeld;
+    uint32_t busLockDepth;
+
+    // Sensor input
+    float rate[3];
+    int16_t bias[3];
+    int16_t noise;
+    uint32_t noiseState;
+
+    // INT1 duration counter
+    uint8_t int1Duration;
+
+    uint32_t halOverhead;
+    uint32_t maxSpiClock;
+    uint32_t busErrors;
+    I3G4250D_Sim_IRQHandler int1Handler;
+    void *int1Context;
+    I3G4250D_Sim_IRQHandler int2Handler;
+    void *int2Context;
+
+    I3G4250D_Sim_BusStats bus;
+    uint32_t samplesGenerated;
+    uint32_t samplesLost;
+} sim;
+
+void I3G4250D_Sim_Reset(void)
+{
+    memset(&sim, 0, sizeof(sim));
+    sim.regs[0x0F] = 0xD3;
+    sim.regs[0x2F] = 0x20;
+    sim.expectAddress = true;
+    sim.halOverhead = 150;
+    sim.maxSpiClock = 10000000U;
+    sim.noiseState = 12345;
+}
+
+void I3G4250D_Sim_SetRate(float x, float y, float z)
+{
+    sim.rate[0] = x;
+    sim.rate[1] = y;
+    sim.rate[2] = z;
+}
+
+void I3G4250D_Sim_SetBias(int16_t x, int16_t y, int16_t z)
+{
+    sim.bias[0] = x;
+    sim.bias[1] = y;
+    sim.bias[2] = z;
+}
+
+void I3G4250D_Sim_SetNoise(int16_t amplitude)
+{
+    sim.noise = amplitude;
+}
+
+void I3G4250D_Sim_SetTemperature(int8_t temperature)
+{
+    sim.regs[0x26] = (uint8_t)temperature;
+}
+
+void I3G4250D_Sim_SetHalOverhead(uint32_t cycles)
+{
+    sim.halOverhead = cycles;
+}
+
+void I3G4250D_Sim_SetMaxSpiClock(uint32_t hz)
+{
+    sim.maxSpiClock = hz;
+}
+
+void I3G4250D_Sim_SetBusErrors(uint32_t transfers)
+{
+    sim.busErrors = transfers;
+}
+
+void I3G4250D_Sim_SetInt1Handler(I3G4250D_Sim_IRQHandler handler, void *context)
+{
+    sim.int1Handler = handler;
+    sim.int1Context = context;
+}
+
+void I3G4250D_Sim_SetInt2Handler(I3G4250D_Sim_IRQHandler handler, void *context)
+{
+    sim.int2Handler = handler;
+    sim.int2Context = context;
+}
+
+uint64_t I3G4250D_Sim_Cycles(void)
+{
+    return sim.cycles;
+}
+
+uint64_t I3G4250D_Sim_IdleCycles(void)
+{
+    return sim.idleCycles;
+}
+
+I3G4250D_Sim_BusStats I3G4250D_Sim_GetBusStats(void)
+{
+    return sim.bus;
+}
+
+uint32_t I3G4250D_Sim_SamplesGenerated(void)
+{
+    return sim.samplesGenerated;
+}
+
+uint32_t I3G4250D_Sim_SamplesLost(void)
+{
+    return sim.samplesLost;
+}
+
+void I3G4250D_Sim_HoldBus(bool held)
+{
+    sim.busHeld = held;
+}
+
+uint32_t I3G4250D_Sim_BusLockDepth(void)
+{
+    return sim.busLockDepth;
+}
+
+// Recursive like the mutex of the RTOS port, and like it never taken from an interrupt
+HAL_StatusTypeDef I3G4250D_Sim_BusLock(SPI_HandleTypeDef *bus)
+{
+    (void)bus;
+    if (sim.busHeld || sim.interruptDepth > 0)
+    {
+        return HAL_BUSY;
+    }
+    sim.busLockDepth++;
+    return HAL_OK;
+}
+
+void I3G4250D_Sim_BusUnlock(SPI_HandleTypeDef *bus)
+{
+    (void)bus;
+    if (sim.busLockDepth > 0)
+    {
+        sim.busLockDepth--;
+    }
+}
+
+uint8_t I3G4250D_Sim_Register(uint8_t registerAddress)
+{
+    return sim.regs[registerAddress & 0x3F];
+}
+
+//** Sensor model **//
+
+static uint32_t SimOdrHz(void)
+{
+    static const uint32_t odr[4] = {105, 208, 420, 840};
+    return odr[sim.regs[0x20] >> 6];
+}
+
+static bool SimPoweredUp(void)
+{
+    return (sim.regs[0x20] & 0x08) != 0;
+}
+
+static float SimSensitivity(void)
+{
+    switch ((sim.regs[0x23] >> 4) & 0x03)
+    {
+    case 0:
+        return 8.75f;
+    case 1:
+        return 17.5f;
+    default:
+        return 70.0f;
+    }
+}
+
+// ZYXDA and the data available bits of the enabled axes
+static uint8_t SimDataAvailable(void)
+{
+    return (uint8_t)(0x08 | (sim.regs[0x20] & 0x07));
+}
+
+static uint8_t SimFifoMode(void)
+{
+    if ((sim.regs[0x24] & 0x40) == 0)
+    {
+        return 0x00;
+    }
+    return sim.regs[0x2E] & 0xE0;
+}
+
+static int16_t SimNoise(void)
+{
+    if (sim.noise == 0)
+    {
+        return 0;
+    }
+    sim.noiseState = sim.noiseState * 1103515245U + 12345U;
+    return (int16_t)((int32_t)((sim.noiseState >> 16) % (uint32_t)(2 * sim.noise + 1)) - sim.noise);
+}
+
+static int16_t SimSaturate(float value)
+{
+    if (value > 32767.0f)
+    {
+        return 32767;
+    }
+    if (value < -32768.0f)
+    {
+        return -32768;
+    }
+    return (int16_t)value;
+}
+
+static void SimUpdateFifoSource(void)
+{
+    uint8_t watermark = sim.regs[0x2E] & 0x1F;
+    uint8_t source = sim.fifoCount & 0x1F;
+
+    if (sim.fifoCount == 0)
+    {
+        source |= 0x20;
+    }
+    if (sim.fifoCount == SIM_FIFO_SIZE)
+    {
+        source |= 0x40;
+    }
+    if (watermark > 0 && sim.fifoCount >= watermark)
+    {
+        source |= 0x80;
+    }
+    sim.regs[0x2F] = source;
+}
+
+static void SimRaiseInt2(void)
+{
+    if (sim.int2Handler != NULL)
+    {
+        sim.interruptDepth++;
+        sim.int2Handler(sim.int2Context);
+        sim.interruptDepth--;
+    }
+}
+
+static void SimCheckInt1(const SimSample *sample)
+{
+    uint8_t config = sim.regs[0x30];
+    uint8_t source = 0;
+    uint8_t enabled = 0;
+    uint8_t active = 0;
+
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        uint16_t threshold = (uint16_t)(((sim.regs[0x32 + (2 * axis)] & 0x7F) << 8) | sim.regs[0x33 + (2 * axis)]);
+        int32_t magnitude = sample->axis[axis] < 0 ? -(int32_t)sample->axis[axis] : sample->axis[axis];
+        if (config & (0x02 << (2 * axis)))
+        {
+            enabled++;
+            if (magnitude > threshold)
+            {
+                active++;
+                source |= (uint8_t)(0x02 << (2 * axis));
+            }
+        }
+    }
+    if (enabled == 0)
+    {
+        sim.int1Duration = 0;
+        return;
+    }
+
+    bool event = (config & 0x80) ? (active == enabled) : (active > 0);
+    if (!event)
+    {
+        sim.int1Duration = 0;
+        if ((config & 0x40) == 0)
+        {
+            sim.regs[0x31] = 0;
+        }
+        return;
+    }
+    if (sim.int1Duration < 0x7F)
+    {
+        sim.int1Duration++;
+    }
+    if (sim.int1Duration <= (sim.regs[0x38] & 0x7F) || (sim.regs[0x31] & 0x40))
+    {
+        return;
+    }
+
+    // Interrupt active, raise the line on the rising edge
+    sim.regs[0x31] = 0x40 | source;
+    sim.fifoTriggered = true;
+    if ((sim.regs[0x22] & 0x80) && sim.int1Handler != NULL)
+    {
+        sim.interruptDepth++;
+        sim.int1Handler(sim.int1Context);
+        sim.interruptDepth--;
+    }
+}
+
+static void SimGenerateSample(void)
+{
+    SimSample sample;
+    float sensitivity = SimSensitivity();
+    uint8_t fifoMode = SimFifoMode();
+    bool dataReadyBefore = (sim.regs[0x27] & 0x08) != 0;
+    bool watermarkBefore = (sim.regs[0x2F] & 0x80) != 0;
+
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        if (sim.regs[0x20] & (1 << axis))
+        {
+            sample.axis[axis] = SimSaturate((sim.rate[axis] * 1000.0f / sensitivity) + sim.bias[axis] + SimNoise());
+        }
+        else
+        {
+            sample.axis[axis] = 0;
+        }
+    }
+    sim.samplesGenerated++;
+
+    // Stream-to-FIFO and bypass-to-stream switch on an INT1 event
+    if (fifoMode == 0x60)
+    {
+        fifoMode = sim.fifoTriggered ? 0x20 : 0x40;
+    }
+    else if (fifoMode == 0x80)
+    {
+        fifoMode = sim.fifoTriggered ? 0x40 : 0x00;
+    }
+
+    if (fifoMode == 0x00)
+    {
+        // Output registers, a sample that was not read yet is lost
+        if (sim.regs[0x27] & 0x08)
+        {
+            sim.samplesLost++;
+            sim.regs[0x27] |= (uint8_t)(0x80 | ((sim.regs[0x27] & 0x07) << 4));
+        }
+        sim.output = sample;
+        sim.regs[0x27] |= SimDataAvailable();
+    }
+    else if (sim.fifoCount < SIM_FIFO_SIZE)
+    {
+        sim.fifo[(sim.fifoHead + sim.fifoCount) % SIM_FIFO_SIZE] = sample;
+        sim.fifoCount++;
+    }
+    else if (fifoMode == 0x40)
+    {
+        // Stream mode overwrites the oldest sample
+        sim.fifo[sim.fifoHead] = sample;
+        sim.fifoHead = (sim.fifoHead + 1) % SIM_FIFO_SIZE;
+        sim.samplesLost++;
+    }
+    else
+    {
+        // FIFO mode stops collecting once full
+        sim.samplesLost++;
+    }
+    if (fifoMode != 0x00)
+    {
+        sim.output = sim.fifo[sim.fifoHead];
+        if (sim.fifoCount == SIM_FIFO_SIZE)
+        {
+            sim.regs[0x27] |= (uint8_t)(0x80 | (SimDataAvailable() << 4));
+        }
+        sim.regs[0x27] |= SimDataAvailable();
+    }
+    SimUpdateFifoSource();
+
+    SimCheckInt1(&sample);
+
+    // INT2 data ready and watermark are edge triggered
+    if ((sim.regs[0x22] & 0x08) && !(fifoMode == 0x00 && dataReadyBefore))
+    {
+        SimRaiseInt2();
+    }
+    else if ((sim.regs[0x22] & 0x04) && !watermarkBefore && (sim.regs[0x2F] & 0x80))
+    {
+        SimRaiseInt2();
+    }
+}
+
+// Run the sensor and the DMA controller up to the current time
+static void SimRunEvents(void)
+{
+    if (sim.inTransfer)
+    {
+        return;
+    }
+    sim.inTransfer = true;
+
+    if (!SimPoweredUp())
+    {
+        sim.nextSampleCycle = 0;
+    }
+    else
+    {
+        uint64_t period = SystemCoreClock / SimOdrHz();
+        if (sim.nextSampleCycle == 0)
+        {
+            sim.nextSampleCycle = sim.cycles + period;
+        }
+        while (sim.nextSampleCycle <= sim.cycles)
+        {
+            SimGenerateSample();
+            sim.nextSampleCycle += period;
+        }
+    }
+
+    if (sim.dmaHandle != NULL && sim.dmaDoneCycle <= sim.cycles)
+    {
+        SPI_HandleTypeDef *hspi = sim.dmaHandle;
+        sim.dmaHandle = NULL;
+        sim.inTransfer = false;
+        sim.interruptDepth++;
+        HAL_SPI_TxRxCpltCallback(hspi);
+        sim.interruptDepth--;
+        return;
+    }
+    sim.inTransfer = false;
+}
+
+void I3G4250D_Sim_Advance(uint64_t cycles)
+{
+    uint64_t end = sim.cycles + cycles;
+
+    SimRunEvents();
+    // Step through sample and DMA events so interrupts fire at the right time
+    while (sim.cycles < end)
+    {
+        uint64_t next = end;
+        if (sim.nextSampleCycle > sim.cycles && sim.nextSampleCycle < next)
+        {
+            next = sim.nextSampleCycle;
+        }
+        if (sim.dmaHandle != NULL && sim.dmaDoneCycle > sim.cycles && sim.dmaDoneCycle < next)
+        {
+            next = sim.dmaDoneCycle;
+        }
+        sim.idleCycles += next - sim.cycles;
+        sim.cycles = next;
+        SimRunEvents();
+    }
+    SimRunEvents();
+}
+
+//** Register access **//
+
+static bool SimFifoActive(void)
+{
+    return SimFifoMode() != 0x00;
+}
+
+static uint8_t SimReadRegister(uint8_t address)
+{
+    if (address >= 0x28 && address <= 0x2D)
+    {
+        uint8_t axis = (address - 0x28) / 2;
+        uint16_t value = (uint16_t)sim.output.axis[axis];
+        if ((address & 1) == 0)
+        {
+            return (uint8_t)(value & 0xFF);
+        }
+        // Reading the high byte clears the axis data available and overrun flags
+        sim.regs[0x27] &= (uint8_t)~((1 << axis) | (0x10 << axis));
+        if ((sim.regs[0x27] & 0x07) == 0)
+        {
+            sim.regs[0x27] &= (uint8_t)~0x08;
+        }
+        if ((sim.regs[0x27] & 0x70) == 0)
+        {
+            sim.regs[0x27] &= (uint8_t)~0x80;
+        }
+        // OUT_Z_H is the last byte of a FIFO slot
+        if (address == 0x2D && SimFifoActive() && sim.fifoCount > 0)
+        {
+            sim.fifoHead = (sim.fifoHead + 1) % SIM_FIFO_SIZE;
+            sim.fifoCount--;
+            sim.output = sim.fifo[sim.fifoHead];
+            if (sim.fifoCount > 0)
+            {
+                sim.regs[0x27] |= SimDataAvailable();
+            }
+            SimUpdateFifoSource();
+        }
+        return (uint8_t)(value >> 8);
+    }
+    if (address == 0x31)
+    {
+        // Reading INT1_SRC clears a latched interrupt
+        uint8_t value = sim.regs[0x31];
+        sim.regs[0x31] = 0;
+        return value;
+    }
+    return sim.regs[address];
+}
+
+static void SimWriteRegister(uint8_t address, uint8_t value)
+{
+    switch (address)
+    {
+    case 0x20:
+        // Powering up starts the sample clock
+        if ((value & 0x08) && !SimPoweredUp())
+        {
+            sim.nextSampleCycle = sim.cycles + (SystemCoreClock / ((uint32_t[]){105, 208, 420, 840})[value >> 6]);
+        }
+        sim.regs[address] = value;
+        break;
+
+    case 0x21:
+    case 0x22:
+    case 0x23:
+    case 0x25:
+    case 0x30:
+    case 0x32:
+    case 0x33:
+    case 0x34:
+    case 0x35:
+    case 0x36:
+    case 0x37:
+    case 0x38:
+        sim.regs[address] = value;
+        break;
+
+    case 0x24:
+        sim.regs[address] = value;
+        if ((value & 0x40) == 0)
+        {
+            sim.fifoCount = 0;
+            SimUpdateFifoSource();
+        }
+        break;
+
+    case 0x2E:
+        // Moving through bypass mode resets the FIFO
+        if ((value & 0xE0) == 0x00)
+        {
+            sim.fifoCount = 0;
+            sim.fifoTriggered = false;
+        }
+        sim.regs[address] = value;
+        SimUpdateFifoSource();
+        break;
+
+    default:
+        // Read only or reserved
+        break;
+    }
+}
+
+static uint8_t SimNextAddress(uint8_t address)
+{
+    // With the FIFO enabled the output registers wrap so the whole FIFO can be read in one burst
+    if (address == 0x2D && (sim.regs[0x24] & 0x40))
+    {
+        return 0x28;
+    }
+    return (uint8_t)((address + 1) & 0x3F);
+}
+
+static uint32_t SimSpiClock(SPI_HandleTypeDef *hspi)
+{
+    return SIM_PCLK2 >> (1 + ((hspi->Init.BaudRatePrescaler >> 3) & 0x07));
+}
+
+static uint8_t SimExchange(SPI_HandleTypeDef *hspi, uint8_t mosi)
+{
+    uint8_t miso = 0xFF;
+
+    if (!sim.selected)
+    {
+        return miso;
+    }
+    if (sim.expectAddress)
+    {
+        sim.expectAddress = false;
+        sim.readTransfer = (mosi & 0x80) != 0;
+        sim.autoIncrement = (mosi & 0x40) != 0;
+        sim.address = mosi & 0x3F;
+        return miso;
+    }
+    if (sim.readTransfer)
+    {
+        miso = SimReadRegister(sim.address);
+        // Clocking faster than the sensor supports corrupts the data
+        if (SimSpiClock(hspi) > sim.maxSpiClock)
+        {
+            miso ^= (uint8_t)(0x01 << (sim.address & 0x07));
+        }
+    }
+    else
+    {
+        SimWriteRegister(sim.address, mosi);
+    }
+    if (sim.autoIncrement)
+    {
+        sim.address = SimNextAddress(sim.address);
+    }
+    return miso;
+}
+
+// Cycles the bus needs to clock `size` bytes
+static uint64_t SimBusCycles(SPI_HandleTypeDef *hspi, uint16_t size)
+{
+    return ((uint64_t)size * 8U * SystemCoreClock) / SimSpiClock(hspi);
+}
+
+static HAL_StatusTypeDef SimTransfer(SPI_HandleTypeDef *hspi, uint8_t *tx, uint8_t *rx, uint16_t size)
+{
+    if (sim.dmaHandle != NULL)
+    {
+        return HAL_BUSY;
+    }
+    if (sim.busErrors > 0)
+    {
+        sim.busErrors--;
+        sim.cycles += sim.halOverhead;
+        return HAL_ERROR;
+    }
+    sim.inTransfer = true;
+    for (uint16_t i = 0; i < size; i++)
+    {
+        uint8_t miso = SimExchange(hspi, tx != NULL ? tx[i] : 0x00);
+        if (rx != NULL)
+        {
+            rx[i] = miso;
+        }
+    }
+    sim.bus.bytes += size;
+    sim.cycles += sim.halOverhead + SimBusCycles(hspi, size);
+    sim.inTransfer = false;
+    return HAL_OK;
+}
+
+//** HAL **//
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+    sim.cycles += sim.halOverhead;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    return SimTransfer(hspi, pData, NULL, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    return SimTransfer(hspi, NULL, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    return SimTransfer(hspi, pTxData, pRxData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size)
+{
+    uint32_t overhead = sim.halOverhead;
+
+    if (sim.dmaHandle != NULL)
+    {
+        return HAL_BUSY;
+    }
+    // The bytes are exchanged up front, the CPU only pays for starting the transfer
+    sim.halOverhead = 0;
+    SimTransfer(hspi, pTxData, pRxData, Size);
+    sim.halOverhead = overhead;
+    sim.cycles -= SimBusCycles(hspi, Size);
+    sim.cycles += overhead;
+    sim.bus.dmaTransfers++;
+    sim.dmaHandle = hspi;
+    sim.dmaDoneCycle = sim.cycles + SimBusCycles(hspi, Size);
+    return HAL_OK;
+}
+
+__weak void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+}
+
+__weak void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    (void)GPIOx;
+    (void)GPIO_Pin;
+    sim.cycles += sim.halOverhead / 4;
+    if (PinState == GPIO_PIN_RESET && !sim.selected)
+    {
+        sim.selected = true;
+        sim.expectAddress = true;
+        sim.bus.transactions++;
+    }
+    else if (PinState == GPIO_PIN_SET)
+    {
+        sim.selected = false;
+    }
+}
+
+uint32_t HAL_GetTick(void)
+{
+    sim.cycles += SIM_GETTICK_CYCLES;
+    SimRunEvents();
+    return (uint32_t)(sim.cycles / (SystemCoreClock / 1000U));
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    I3G4250D_Sim_Advance((uint64_t)Delay * (SystemCoreClock / 1000U));
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return SIM_PCLK1;
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void)
+{
+    return SIM_PCLK2;
+}
+
+DWT_Type *I3G4250D_Sim_DWT(void)
+{
+    sim.dwt.CYCCNT = (uint32_t)sim.cycles;
+    return &sim.dwt;
+}
@@ -0,0 +1,64 @@
+/*
+Simulated I3G4250D for the host build.
+Models the register map, the output data rate, the FIFO modes, the STATUS_REG/FIFO_SRC_REG overrun flags,
+the INT1 threshold and INT2 data ready/watermark interrupts and the SPI bus timing, on a virtual core clock.
+Interrupt handlers and DMA completions are delivered whenever simulated time advances outside of a blocking transfer.
+*/
+
+#ifndef I3G4250D_SIM_H
+#define I3G4250D_SIM_H
+
+#include "I3G4250D_Host.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*I3G4250D_Sim_IRQHandler)(void *context);
+
+// Bus traffic since the last reset
+typedef struct
+{
+    uint64_t bytes;                                             // Bytes clocked on the bus, including address bytes
+    uint32_t transactions;                                      // CS assertions
+    uint32_t dmaTransfers;
+} I3G4250D_Sim_BusStats;
+
+void I3G4250D_Sim_Reset(void);
+
+// Sensor input
+void I3G4250D_Sim_SetRate(float x, float y, float z);           // Angular rate in DPS
+void I3G4250D_Sim_SetBias(int16_t x, int16_t y, int16_t z);     // Zero rate level in digits
+void I3G4250D_Sim_SetNoise(int16_t amplitude);                  // Peak noise in digits
+void I3G4250D_Sim_SetTemperature(int8_t temperature);           // OUT_TEMP value
+
+// Bus and CPU timing
+void I3G4250D_Sim_SetHalOverhead(uint32_t cycles);              // CPU cycles spent per HAL call
+void I3G4250D_Sim_SetMaxSpiClock(uint32_t hz);                  // Above this clock reads return corrupted data
+void I3G4250D_Sim_SetBusErrors(uint32_t transfers);             // The next `transfers` HAL transfers fail with HAL_ERROR, clocking nothing
+
+// Shared bus, see I3G4250D_SIM_BUS_LOCK in I3G4250D_Host.h
+void I3G4250D_Sim_HoldBus(bool held);                           // Another client holds the bus, locking it returns HAL_BUSY
+uint32_t I3G4250D_Sim_BusLockDepth(void);                       // Nesting level of the driver's bus lock, 0 when released
+
+// Interrupt lines, called like an EXTI handler on the rising edge
+void I3G4250D_Sim_SetInt1Handler(I3G4250D_Sim_IRQHandler handler, void *context);
+void I3G4250D_Sim_SetInt2Handler(I3G4250D_Sim_IRQHandler handler, void *context);
+
+// Time
+void I3G4250D_Sim_Advance(uint64_t cycles);                     // Let the CPU idle, delivering interrupts
+uint64_t I3G4250D_Sim_Cycles(void);
+uint64_t I3G4250D_Sim_IdleCycles(void);                         // Cycles spent in HAL_Delay / I3G4250D_Sim_Advance outside of interrupts
+
+// Observation
+I3G4250D_Sim_BusStats I3G4250D_Sim_GetBusStats(void);
+uint32_t I3G4250D_Sim_SamplesGenerated(void);
+uint32_t I3G4250D_Sim_SamplesLost(void);                        // Samples overwritten before they were read
+uint8_t I3G4250D_Sim_Register(uint8_t registerAddress);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
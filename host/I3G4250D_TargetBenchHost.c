@@ -0,0 +1,17 @@
+/*
+Runs the on-target microbenchmark (bench/I3G4250D_TargetBench.c) against the simulated gyroscope, to check the benchmark
+itself and its output format without a board. The cycle counts only cover the simulated HAL calls and bus transfers.
+*/
+
+#include "I3G4250D_TargetBench.h"
+#include "I3G4250D_Sim.h"
+
+int main(void)
+{
+    static SPI_HandleTypeDef spi;
+
+    I3G4250D_Sim_Reset();
+    I3G4250D_Sim_SetRate(10.0f, -20.0f, 100.0f);
+    I3G4250D_TargetBench_Run(&spi, GPIOC, GPIO_PIN_1);
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*
+Host side of the telemetry packets (I3G4250D_Telemetry.c).
+    I3G4250D_TelemetryDecode [file]    decode a captured stream (or stdin) to CSV: sequence,timestamp,x,y,z
+    I3G4250D_TelemetryDecode -e [n]    encode n FIFO drains of the simulated gyroscope to stdout, to check the decoder
+The statistics go to stderr. The exit code is non-zero when a packet failed the CRC or went missing, or when the encoder
+compressed the simulated stream by less than I3G4250D_TELEMETRY_MIN_RATIO.
+*/
+
+#include "I3G4250D_Telemetry.h"
+#include "I3G4250D_Sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define I3G4250D_TELEMETRY_MIN_RATIO     2.0
+
+static int I3G4250D_TelemetryHostEncode(unsigned long blocks)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static SPI_HandleTypeDef spi;
+    static I3G4250D_TelemetryEncoderTypeDef encoder;
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_DataRaw samples[I3G4250D_FIFO_SIZE];
+    uint64_t rawBytes = 0;
+    uint64_t packetBytes = 0;
+    double ratio;
+
+    I3G4250D_Sim_Reset();
+    I3G4250D_Sim_SetBias(12, -8, 4);
+    I3G4250D_Sim_SetNoise(6);
+    spi.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_16;
+
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_HIGH;
+    init.FIFO_MODE = I3G4250D_FIFO_MODE_STREAM;
+    I3G4250D_Init(&gyro, &spi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_TelemetryEncoderInit(&encoder);
+
+    for (unsigned long b = 0; b < blocks; b++)
+    {
+        const uint8_t *packet;
+        size_t n;
+        size_t size;
+
+        // A slow turn that speeds up, then stops
+        I3G4250D_Sim_SetRate(0.5f * (float)(b % 40), -0.25f * (float)(b % 40), b % 80 < 40 ? 30.0f : 0.0f);
+        HAL_Delay(((I3G4250D_FIFO_SIZE + 1) * 1000U) / I3G4250D_GetODR(&gyro) + 1U);
+        n = I3G4250D_ReadFifo(&gyro, samples, I3G4250D_FIFO_SIZE);
+        if (n == 0)
+        {
+            continue;
+        }
+        size = I3G4250D_TelemetryEncode(&encoder, samples, n, I3G4250D_GetTimestamp(), gyro.samplePeriod, &packet);
+        fwrite(packet, 1, size, stdout);
+        // The write stands in for a UART DMA transfer that is complete once fwrite returns
+        I3G4250D_TelemetryRelease(&encoder, packet);
+        rawBytes += n * sizeof(I3G4250D_DataRaw);
+        packetBytes += size;
+    }
+    ratio = packetBytes ? (double)rawBytes / (double)packetBytes : 0.0;
+    fprintf(stderr, "encoded %lu blocks, %llu raw bytes in %llu packet bytes, %.2fx %s\n", blocks,
+            (unsigned long long)rawBytes, (unsigned long long)packetBytes, ratio,
+            ratio >= I3G4250D_TELEMETRY_MIN_RATIO ? "ok" : "FAIL");
+    return ratio >= I3G4250D_TELEMETRY_MIN_RATIO ? 0 : 1;
+}
+
+static int I3G4250D_TelemetryHostDecode(FILE *in)
+{
+    static I3G4250D_TelemetryDecoderTypeDef decoder;
+    static I3G4250D_TelemetryPacketTypeDef packet;
+    uint64_t samples = 0;
+    int c;
+
+    I3G4250D_TelemetryDecoderInit(&decoder);
+    printf("sequence,timestamp,x,y,z\n");
+    while ((c = fgetc(in)) != EOF)
+    {
+        if (!I3G4250D_TelemetryDecodeByte(&decoder, (uint8_t)c, &packet))
+        {
+            continue;
+        }
+        for (size_t i = 0; i < packet.count; i++)
+        {
+            printf("%u,%lu,%d,%d,%d\n", packet.sequence, (unsigned long)(packet.timestamp + i * packet.period),
+                   packet.samples[i].x, packet.samples[i].y, packet.samples[i].z);
+        }
+        samples += packet.count;
+    }
+    fprintf(stderr, "decoded %lu packets, %llu samples, %lu CRC errors, %lu lost packets\n",
+            (unsigned long)decoder.packets, (unsigned long long)samples,
+            (unsigned long)decoder.crcErrors, (unsigned long)decoder.lostPackets);
+    return (decoder.crcErrors == 0 && decoder.lostPackets == 0) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    FILE *in = stdin;
+    int result;
+
+    if (argc > 1 && argv[1][0] == '-' && argv[1][1] == 'e')
+    {
+        return I3G4250D_TelemetryHostEncode(argc > 2 ? strtoul(argv[2], NULL, 0) : 100UL);
+    }
+    if (argc > 1)
+    {
+        in = fopen(argv[1], "rb");
+        if (in == NULL)
+        {
+            perror(argv[1]);
+            return 2;
+        }
+    }
+    result = I3G4250D_TelemetryHostDecode(in);
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+    return result;
+}
@@ -0,0 +1,86 @@
+/*
+Compile and run check of the header only C++ driver (../I3G4250D.hpp) on the simulated gyroscope.
+Instantiates the template for several axis sets, including a Z only one that bursts from OUT_Z_L, and checks the burst
+length on the bus, the decoded samples against the simulated zero rate level and the rounding of the fixed point bias.
+Exits with a non-zero status when a check fails.
+*/
+
+#include "I3G4250D.hpp"
+#include "I3G4250D_Sim.h"
+#include <stdio.h>
+
+static SPI_HandleTypeDef testSpi;
+
+// GPIOC is not a constant expression on the host, so I3G4250D_HalPin cannot name it
+struct TestPin
+{
+    static void Write(bool level)
+    {
+        I3G4250D_CS_WRITE(GPIOC, GPIO_PIN_1, level ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    }
+};
+
+template <uint8_t Axes>
+using TestGyro = I3G4250D<I3G4250D_HalSpi<&testSpi>, TestPin, I3G4250D_SCALE_500, Axes>;
+
+static_assert(TestGyro<I3G4250D_ENABLE_ALL_AXIS>::FirstAxis == 0 && TestGyro<I3G4250D_ENABLE_ALL_AXIS>::BurstSize == 7, "XYZ burst");
+static_assert(TestGyro<I3G4250D_ENABLE_Y>::FirstAxis == 1 && TestGyro<I3G4250D_ENABLE_Y>::BurstSize == 3, "Y burst");
+static_assert(TestGyro<I3G4250D_ENABLE_Z>::FirstAxis == 2 && TestGyro<I3G4250D_ENABLE_Z>::BurstSize == 3, "Z burst");
+static_assert(TestGyro<(uint8_t)(I3G4250D_ENABLE_X | I3G4250D_ENABLE_Z)>::BurstSize == 7, "XZ burst spans Y");
+
+// Expected value of an axis, 0 when it is disabled
+static int32_t TestExpect(bool enabled, int32_t value)
+{
+    return enabled ? value : 0;
+}
+
+template <uint8_t Axes>
+static bool TestTemplate(const char *name)
+{
+    using Gyro = TestGyro<Axes>;
+    Gyro gyro;
+    I3G4250D_Sim_BusStats before;
+    uint64_t burstBytes;
+    I3G4250D_DataRaw raw;
+    I3G4250D_DataFixed fixed;
+    bool pass;
+
+    I3G4250D_Sim_Reset();
+    I3G4250D_Sim_SetRate(0.0f, 0.0f, 0.0f);
+    I3G4250D_Sim_SetNoise(0);
+    I3G4250D_Sim_SetBias(100, -200, 300);
+    testSpi.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_16;
+
+    gyro.Init(I3G4250D_ODR_BW_LOW);
+    HAL_Delay(50);
+    while (!gyro.DataReady())
+    {
+    }
+    before = I3G4250D_Sim_GetBusStats();
+    raw = gyro.GetRawData();
+    burstBytes = I3G4250D_Sim_GetBusStats().bytes - before.bytes;
+
+    // Half-way and beyond are rounded away from zero, truncation would give 2, -2 and 2
+    gyro.SetBias(2.6f, -2.5f, 2.4f);
+    fixed = gyro.ScaleFixed(I3G4250D_DataRaw{0, 0, 0});
+
+    pass = burstBytes == Gyro::BurstSize
+        && raw.x == TestExpect(Gyro::HasX, 100) && raw.y == TestExpect(Gyro::HasY, -200) && raw.z == TestExpect(Gyro::HasZ, 300)
+        && fixed.x == TestExpect(Gyro::HasX, -3) && fixed.y == TestExpect(Gyro::HasY, 3) && fixed.z == TestExpect(Gyro::HasZ, -2)
+        && I3G4250D_Sim_Register(I3G4250D_CTRL_REG1) == Gyro::Ctrl1(I3G4250D_ODR_BW_LOW)
+        && I3G4250D_Sim_Register(I3G4250D_CTRL_REG4) == Gyro::Ctrl4;
+    printf("%-4s burst %llu bytes, raw %6d %6d %6d, fixed bias %3ld %3ld %3ld  %s\n", name, (unsigned long long)burstBytes,
+           raw.x, raw.y, raw.z, (long)fixed.x, (long)fixed.y, (long)fixed.z, pass ? "ok" : "FAIL");
+    return pass;
+}
+
+int main(void)
+{
+    bool pass = true;
+
+    pass &= TestTemplate<I3G4250D_ENABLE_ALL_AXIS>("xyz");
+    pass &= TestTemplate<I3G4250D_ENABLE_Z>("z");
+    pass &= TestTemplate<I3G4250D_ENABLE_Y>("y");
+    pass &= TestTemplate<(uint8_t)(I3G4250D_ENABLE_X | I3G4250D_ENABLE_Z)>("xz");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+/*
+Harness of the functional checks of the I3G4250D driver on the simulated gyroscope, see I3G4250D_Test.c.
+Every check lives in host/test next to the other checks of its feature, brings the simulator and its own handles into
+the state it needs through the driver API and reports one line through TestReport.
+*/
+
+#ifndef I3G4250D_TEST_H
+#define I3G4250D_TEST_H
+
+#include "I3G4250D.h"
+#include "I3G4250D_Sim.h"
+#include <stdbool.h>
+
+// SPI bus of the simulated gyroscope
+extern SPI_HandleTypeDef testSpi;
+
+// Fresh simulator without interrupt handlers, testSpi back at SPI_BAUDRATEPRESCALER_16
+void TestReset(void);
+// Deliver the INT1 and INT2 edges of the simulator to the driver handlers of `gyro`
+void TestRouteInterrupts(I3G4250D_HandleTypeDef *gyro);
+// Stop the interrupts, wait for a DMA transfer in flight and release the instance slot of `gyro`
+void TestRelease(I3G4250D_HandleTypeDef *gyro);
+// Print one result line and pass the result on
+bool TestReport(const char *name, bool pass, const char *format, ...);
+// Distance of a bias in MDPS from a zero rate level in digits, at the sensitivity of `gyro`
+float TestBiasError(const I3G4250D_HandleTypeDef *gyro, float biasMdps, int16_t digits);
+
+// Checks
+bool TestBurstRead(const char *name);
+bool TestFifoDrain(const char *name);
+bool TestDmaRead(const char *name);
+bool TestDataReadyInt2(const char *name);
+bool TestRingBuffer(const char *name);
+bool TestInstances(const char *name);
+bool TestFixedPoint(const char *name);
+bool TestScaleBlock(const char *name);
+bool TestTransferIO(const char *name);
+bool TestShadowRegisters(const char *name);
+bool TestFifoTimestamps(const char *name);
+bool TestBiasEstimator(const char *name);
+bool TestAutoCalibrate(const char *name);
+bool TestAttitude(const char *name);
+bool TestStats(const char *name);
+bool TestOverruns(const char *name);
+bool TestAxes(const char *name);
+bool TestAdaptiveOdr(const char *name);
+bool TestSleepWake(const char *name);
+bool TestBusLock(const char *name);
+bool TestLLTransfer(const char *name);
+bool TestInitStep(const char *name);
+bool TestBlockCapture(const char *name);
+bool TestDecimator(const char *name);
+bool TestTelemetry(const char *name);
+bool TestTempComp(const char *name);
+bool TestTuneSpiClock(const char *name);
+
+#endif
@@ -0,0 +1,69 @@
+/*
+Adaptive output data rate on the INT2 data ready path, see I3G4250D_AdaptiveOdrInit and I3G4250D_AdaptiveOdrService.
+*/
+
+#include "I3G4250D_Test.h"
+
+// ODR/bandwidth bits of the simulated CTRL_REG1
+static uint8_t TestAdaptivePreset(void)
+{
+    return I3G4250D_Sim_Register(I3G4250D_CTRL_REG1) & 0xF0;
+}
+
+// Service call from the main loop, retried while a DMA read holds the bus
+static bool TestAdaptiveService(I3G4250D_HandleTypeDef *gyro)
+{
+    for (uint32_t t = 0; t < 10; t++)
+    {
+        if (I3G4250D_AdaptiveOdrService(gyro))
+        {
+            return true;
+        }
+        HAL_Delay(1);
+    }
+    return false;
+}
+
+bool TestAdaptiveOdr(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    uint32_t lowPeriod;
+    bool still;
+    bool decided;
+    bool up;
+    bool down;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.DRDY_MODE = I3G4250D_DRDY_INT2;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    TestRouteInterrupts(&gyro);
+    I3G4250D_AdaptiveOdrInit(&gyro, I3G4250D_ODR_BW_LOW, I3G4250D_ODR_BW_ULTRA, 50000, 200);
+    lowPeriod = gyro.samplePeriod;
+
+    // At rest nothing is decided
+    HAL_Delay(100);
+    still = !gyro.adaptiveOdr.pending && TestAdaptivePreset() == I3G4250D_ODR_BW_LOW;
+
+    // Motion: the completion interrupt only decides, the register is written by the service call
+    I3G4250D_Sim_SetRate(0.0f, 0.0f, 100.0f);
+    HAL_Delay(30);
+    decided = gyro.adaptiveOdr.pending && TestAdaptivePreset() == I3G4250D_ODR_BW_LOW;
+    up = TestAdaptiveService(&gyro) && TestAdaptivePreset() == I3G4250D_ODR_BW_ULTRA && gyro.adaptiveOdr.high
+      && gyro.samplePeriod < lowPeriod / 4U;
+
+    // Quiet for longer than quietMs at the high rate, back to the low preset
+    I3G4250D_Sim_SetRate(0.0f, 0.0f, 0.0f);
+    HAL_Delay(300);
+    down = gyro.adaptiveOdr.pending && TestAdaptiveService(&gyro) && TestAdaptivePreset() == I3G4250D_ODR_BW_LOW
+        && !gyro.adaptiveOdr.high && gyro.samplePeriod == lowPeriod && gyro.adaptiveOdr.switches == 2;
+    I3G4250D_AdaptiveOdrDisable(&gyro);
+    TestRelease(&gyro);
+
+    return TestReport(name, still && decided && up && down,
+                      "still %d, decided in the interrupt %d, up %d, down %d, %lu switches",
+                      still, decided, up, down, (unsigned long)gyro.adaptiveOdr.switches);
+}
@@ -0,0 +1,66 @@
+/*
+Quaternion integration of the timestamped FIFO samples, see I3G4250D_AttitudeUpdate and I3G4250D_AttitudeFixedUpdate.
+*/
+
+#include "I3G4250D_Test.h"
+#include "I3G4250D_Attitude.h"
+#include <math.h>
+
+bool TestAttitude(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static I3G4250D_DataRaw raw[I3G4250D_FIFO_SIZE];
+    static I3G4250D_DataStamped stamped[I3G4250D_FIFO_SIZE];
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_AttitudeTypeDef attitude;
+    I3G4250D_AttitudeFixedTypeDef attitudeFixed;
+    uint32_t first = 0;
+    uint32_t last = 0;
+    bool started = false;
+    double expected;
+    double angle;
+    double angleFixed;
+    double norm;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_HIGH;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.FIFO_MODE = I3G4250D_FIFO_MODE_STREAM;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_Sim_SetRate(0.0f, 0.0f, 90.0f);
+    I3G4250D_AttitudeInit(&attitude, I3G4250D_GetTimestampFrequency());
+    I3G4250D_AttitudeFixedInit(&attitudeFixed, I3G4250D_GetTimestampFrequency());
+    HAL_Delay(50);
+    I3G4250D_ReadFifo(&gyro, raw, I3G4250D_FIFO_SIZE);
+
+    // A quarter turn about Z, kept below half a turn so the angle does not wrap
+    for (uint32_t t = 0; t < 1000; t += 20)
+    {
+        size_t n;
+
+        HAL_Delay(20);
+        n = I3G4250D_ReadFifoStamped(&gyro, stamped, I3G4250D_FIFO_SIZE);
+        if (n == 0)
+        {
+            continue;
+        }
+        I3G4250D_AttitudeUpdate(&attitude, &gyro, stamped, n);
+        I3G4250D_AttitudeFixedUpdate(&attitudeFixed, &gyro, stamped, n);
+        if (!started)
+        {
+            first = stamped[0].timestamp;
+            started = true;
+        }
+        last = stamped[n - 1].timestamp;
+    }
+    TestRelease(&gyro);
+    expected = 90.0 * (double)(last - first) / (double)I3G4250D_GetTimestampFrequency();
+    angle = 2.0 * atan2(attitude.q3, attitude.q0) * 180.0 / M_PI;
+    angleFixed = 2.0 * atan2((double)attitudeFixed.q3, (double)attitudeFixed.q0) * 180.0 / M_PI;
+    norm = sqrt((double)attitude.q0 * attitude.q0 + (double)attitude.q1 * attitude.q1
+              + (double)attitude.q2 * attitude.q2 + (double)attitude.q3 * attitude.q3);
+
+    return TestReport(name, fabs(angle - expected) < 0.5 && fabs(angleFixed - expected) < 0.5 && fabs(norm - 1.0) < 1e-3,
+                      "expected %.2f deg, float %.2f, fixed %.2f, norm %.5f", expected, angle, angleFixed, norm);
+}
@@ -0,0 +1,71 @@
+/*
+Reads of a subset of the axes, see I3G4250D_GetRawData, I3G4250D_GetRawAxes and I3G4250D_PackAxes.
+*/
+
+#include "I3G4250D_Test.h"
+
+bool TestAxes(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_DataRaw zSample;
+    I3G4250D_DataRaw raw;
+    I3G4250D_DataRaw block[4];
+    I3G4250D_DataScaled scaled;
+    int16_t packed[3 * 4];
+    uint64_t bytes;
+    uint8_t axes;
+    size_t values;
+    uint8_t level;
+    bool zOnly;
+    bool pairs;
+    bool fifo = true;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_Z;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_Sim_SetRate(10.0f, -20.0f, 100.0f);
+    HAL_Delay(20);
+
+    // Z only is the address byte and OUT_Z_L..OUT_Z_H, the disabled axes read and scale to 0
+    bytes = I3G4250D_Sim_GetBusStats().bytes;
+    zSample = I3G4250D_GetRawData(&gyro);
+    bytes = I3G4250D_Sim_GetBusStats().bytes - bytes;
+    axes = I3G4250D_GetRawAxes(&gyro, packed);
+    block[0].x = 1000;
+    block[0].y = -1000;
+    block[0].z = 1000;
+    scaled = I3G4250D_ConvertScaled(&gyro, &block[0]);
+    zOnly = bytes == 3 && zSample.x == 0 && zSample.y == 0 && zSample.z == 5714 && axes == 1 && packed[0] == 5714
+         && scaled.x == 0.0f && scaled.y == 0.0f && scaled.z != 0.0f;
+
+    // X and Y packed in order, two values per sample
+    I3G4250D_SetEnabledAxis(&gyro, I3G4250D_ENABLE_X | I3G4250D_ENABLE_Y);
+    for (int16_t i = 0; i < 4; i++)
+    {
+        block[i].x = i;
+        block[i].y = (int16_t)(10 + i);
+        block[i].z = (int16_t)(20 + i);
+    }
+    values = I3G4250D_PackAxes(&gyro, block, packed, 4);
+    pairs = values == 8 && packed[0] == 0 && packed[1] == 10 && packed[6] == 3 && packed[7] == 13;
+
+    // With the FIFO every single read still moves a whole slot, so X only pops one sample per read
+    I3G4250D_SetEnabledAxis(&gyro, I3G4250D_ENABLE_X);
+    I3G4250D_SetFifoMode(&gyro, I3G4250D_FIFO_MODE_FIFO, 0);
+    HAL_Delay(400);
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        raw = I3G4250D_GetRawData(&gyro);
+        fifo &= raw.x == 571 && raw.y == 0 && raw.z == 0;
+    }
+    level = I3G4250D_Sim_Register(I3G4250D_FIFO_SRC_REG) & I3G4250D_FIFO_SRC_FSS;
+    fifo &= level == I3G4250D_FIFO_SIZE - 5;
+    TestRelease(&gyro);
+
+    return TestReport(name, zOnly && pairs && fifo,
+                      "Z only %lu bytes raw %d %d %d, %lu values for 4 XY samples, FIFO level %u after 5 X only reads",
+                      (unsigned long)bytes, zSample.x, zSample.y, zSample.z, (unsigned long)values, level);
+}
@@ -0,0 +1,48 @@
+/*
+Online bias estimator, see I3G4250D_BiasEstimatorInit.
+*/
+
+#include "I3G4250D_Test.h"
+#include <math.h>
+
+bool TestBiasEstimator(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    HAL_StatusTypeDef status;
+    float error;
+    bool still;
+    bool moving;
+    bool wideThreshold;
+
+    // Watermark DMA drains feed the estimator from the completion interrupt
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_ULTRA;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_245;
+    init.FIFO_MODE = I3G4250D_FIFO_MODE_STREAM;
+    init.FIFO_WATERMARK = 8;
+    init.DRDY_MODE = I3G4250D_DRDY_INT2_WTM;
+    status = I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    TestRouteInterrupts(&gyro);
+    I3G4250D_Sim_SetBias(100, -50, 30);
+    I3G4250D_Sim_SetNoise(5);
+    I3G4250D_BiasEstimatorInit(&gyro, 50, 64);
+    HAL_Delay(1000);
+    still = I3G4250D_IsStationary(&gyro);
+    error = fmaxf(TestBiasError(&gyro, gyro.X_Bias, 100), TestBiasError(&gyro, gyro.Y_Bias, -50));
+    error = fmaxf(error, TestBiasError(&gyro, gyro.Z_Bias, 30));
+
+    I3G4250D_Sim_SetNoise(400);
+    HAL_Delay(200);
+    moving = !I3G4250D_IsStationary(&gyro);
+
+    // A threshold beyond the tracked variance counts the same noise as standing still
+    I3G4250D_BiasEstimatorInit(&gyro, 1UL << 23, 64);
+    HAL_Delay(500);
+    wideThreshold = I3G4250D_IsStationary(&gyro);
+    TestRelease(&gyro);
+
+    return TestReport(name, status == HAL_OK && still && error <= 1.0f && moving && wideThreshold,
+                      "bias error %.2f digits, still %d, moving %d, wide threshold %d", error, still, moving, wideThreshold);
+}
@@ -0,0 +1,103 @@
+/*
+Double buffered per-axis block capture on the DMA FIFO drains, see I3G4250D_BlockCaptureInit.
+*/
+
+#include "I3G4250D_Test.h"
+#include <stdlib.h>
+
+bool TestBlockCapture(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static I3G4250D_BlockTypeDef blocks[2];
+    static I3G4250D_DataRaw raw[I3G4250D_RING_SIZE];
+    I3G4250D_InitTypeDef init = {0};
+    uint32_t count = 0;
+    uint32_t nextSequence = 0;
+    uint32_t previousTimestamp = 0;
+    uint32_t spacingError = 0;
+    uint32_t dropped;
+    uint32_t polled = 0;
+    bool constant = true;
+    bool ordered = true;
+    bool pollingFills;
+    int16_t x = 0;
+    int16_t z = 0;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_ULTRA;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.FIFO_MODE = I3G4250D_FIFO_MODE_STREAM;
+    init.FIFO_WATERMARK = 16;
+    init.DRDY_MODE = I3G4250D_DRDY_INT2_WTM;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    TestRouteInterrupts(&gyro);
+    I3G4250D_Sim_SetRate(10.0f, -20.0f, 100.0f);
+    I3G4250D_BlockCaptureInit(&gyro, blocks, false);
+
+    // Collect and release a few blocks
+    for (uint32_t t = 0; t < 2500 && count < 4; t++)
+    {
+        I3G4250D_BlockTypeDef *block;
+
+        HAL_Delay(1);
+        I3G4250D_RingPopBlock(&gyro, raw, I3G4250D_RING_SIZE);
+        block = I3G4250D_BlockGet(&gyro);
+        if (block == NULL)
+        {
+            continue;
+        }
+        if (count > 0)
+        {
+            uint32_t spacing = block->timestamp - previousTimestamp;
+            uint32_t expected = I3G4250D_BLOCK_SIZE * gyro.samplePeriod;
+            uint32_t error = spacing > expected ? spacing - expected : expected - spacing;
+
+            spacingError = error > spacingError ? error : spacingError;
+        }
+        ordered &= block->sequence == nextSequence;
+        x = block->x[0];
+        z = block->z[0];
+        for (size_t i = 0; i < I3G4250D_BLOCK_SIZE; i++)
+        {
+            constant &= block->x[i] == x && block->y[i] == block->y[0] && block->z[i] == z;
+        }
+        nextSequence = block->sequence + 1;
+        previousTimestamp = block->timestamp;
+        count++;
+        I3G4250D_BlockRelease(&gyro);
+    }
+
+    // Keep both blocks, the capture has to drop samples
+    while (I3G4250D_BlockGet(&gyro) == NULL)
+    {
+        HAL_Delay(1);
+    }
+    for (uint32_t t = 0; t < 700; t++)
+    {
+        HAL_Delay(1);
+        I3G4250D_RingPopBlock(&gyro, raw, I3G4250D_RING_SIZE);
+    }
+    dropped = I3G4250D_BlockDropped(&gyro);
+    TestRelease(&gyro);
+
+    // Polled FIFO reads are not a block producer, only the DMA completion path fills blocks
+    init.FIFO_WATERMARK = 0;
+    init.DRDY_MODE = I3G4250D_DRDY_POLLING;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_BlockCaptureInit(&gyro, blocks, false);
+    for (uint32_t t = 0; t < 20; t++)
+    {
+        HAL_Delay(20);
+        polled += (uint32_t)I3G4250D_ReadFifo(&gyro, raw, I3G4250D_FIFO_SIZE);
+    }
+    pollingFills = I3G4250D_BlockGet(&gyro) != NULL || gyro.blockCapture.fill != 0;
+    TestRelease(&gyro);
+
+    // 10 and 100 DPS at 17.5 MDPS/digit
+    return TestReport(name, count == 4 && ordered && constant && spacingError <= gyro.samplePeriod / 4U
+                      && abs(x - 571) <= 1 && abs(z - 5714) <= 1 && dropped > 0 && polled > I3G4250D_BLOCK_SIZE && !pollingFills,
+                      "%lu blocks, spacing error %lu ticks, x %d z %d, dropped %lu, %lu polled samples fill blocks %d",
+                      (unsigned long)count, (unsigned long)spacingError, x, z, (unsigned long)dropped,
+                      (unsigned long)polled, pollingFills);
+}
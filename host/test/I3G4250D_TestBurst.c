@@ -0,0 +1,37 @@
+/*
+Single transaction burst read of the three axes, see I3G4250D_GetRawData.
+*/
+
+#include "I3G4250D_Test.h"
+
+bool TestBurstRead(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_Sim_BusStats before;
+    I3G4250D_Sim_BusStats after;
+    I3G4250D_DataRaw raw;
+    HAL_StatusTypeDef status;
+    bool ready;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_HIGH;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    status = I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_Sim_SetRate(10.0f, -20.0f, 100.0f);
+    HAL_Delay(10);
+    ready = I3G4250D_DataReady(&gyro, 10);
+
+    // STATUS_REG and OUT_X_L..OUT_Z_H behind one address byte, in a single chip select
+    before = I3G4250D_Sim_GetBusStats();
+    raw = I3G4250D_GetRawData(&gyro);
+    after = I3G4250D_Sim_GetBusStats();
+    TestRelease(&gyro);
+
+    // 10, -20 and 100 DPS at 17.5 MDPS/digit
+    return TestReport(name, status == HAL_OK && ready && after.transactions - before.transactions == 1
+                      && after.bytes - before.bytes == 8 && raw.x == 571 && raw.y == -1142 && raw.z == 5714,
+                      "%lu transaction of %lu bytes, raw %d %d %d", (unsigned long)(after.transactions - before.transactions),
+                      (unsigned long)(after.bytes - before.bytes), raw.x, raw.y, raw.z);
+}
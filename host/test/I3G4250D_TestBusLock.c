@@ -0,0 +1,58 @@
+/*
+Blocking transactions on a bus held by another client, see I3G4250D_ReadIO and I3G4250D_WriteIO.
+The test build maps I3G4250D_BUS_LOCK to the lock of the simulator with I3G4250D_SIM_BUS_LOCK.
+*/
+
+#include "I3G4250D_Test.h"
+
+bool TestBusLock(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_Sim_BusStats before;
+    I3G4250D_DataRaw raw;
+    uint8_t buffer[2] = {0xAA, 0x55};
+    uint8_t value = 0x12;
+    HAL_StatusTypeDef readStatus;
+    HAL_StatusTypeDef writeStatus;
+    HAL_StatusTypeDef tuneStatus;
+    uint32_t heldTransactions;
+    bool untouched;
+    bool ready;
+    bool released;
+    bool balanced;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_HIGH;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_Sim_SetRate(10.0f, -20.0f, 100.0f);
+    HAL_Delay(10);
+
+    // Held by another client: nothing reaches the bus, the buffer is left alone and no sample is made up
+    I3G4250D_Sim_HoldBus(true);
+    before = I3G4250D_Sim_GetBusStats();
+    readStatus = I3G4250D_ReadIO(&gyro, I3G4250D_CTRL_REG1, buffer, sizeof(buffer));
+    untouched = buffer[0] == 0xAA && buffer[1] == 0x55;
+    writeStatus = I3G4250D_WriteIO(&gyro, I3G4250D_INT1_THS_XL_REG, &value, 1);
+    ready = I3G4250D_DataReady(&gyro, 5);
+    raw = I3G4250D_GetRawData(&gyro);
+    tuneStatus = I3G4250D_TuneSpiClock(&gyro, 0, 0);
+    heldTransactions = I3G4250D_Sim_GetBusStats().transactions - before.transactions;
+    I3G4250D_Sim_HoldBus(false);
+
+    // Released, the nested locks of the clock tuning unwind like the single ones
+    released = I3G4250D_ReadIO(&gyro, I3G4250D_CTRL_REG1, buffer, sizeof(buffer)) == HAL_OK
+            && buffer[0] == gyro.shadow[0] && buffer[1] == gyro.shadow[1]
+            && I3G4250D_TuneSpiClock(&gyro, 0, 0) == HAL_OK;
+    balanced = I3G4250D_Sim_BusLockDepth() == 0;
+    TestRelease(&gyro);
+
+    return TestReport(name, readStatus == HAL_BUSY && writeStatus == HAL_BUSY && tuneStatus == HAL_BUSY
+                      && untouched && heldTransactions == 0 && I3G4250D_Sim_Register(I3G4250D_INT1_THS_XL_REG) != value
+                      && !ready && raw.x == 0 && raw.y == 0 && raw.z == 0 && released && balanced,
+                      "held: read %d write %d tune %d, %lu transactions, ready %d, raw %d %d %d; released %d, lock depth %lu",
+                      readStatus, writeStatus, tuneStatus, (unsigned long)heldTransactions, ready, raw.x, raw.y, raw.z,
+                      released, (unsigned long)I3G4250D_Sim_BusLockDepth());
+}
@@ -0,0 +1,38 @@
+/*
+Bias calibration from FIFO bursts at the fastest rate, see I3G4250D_AutoCalibrate.
+*/
+
+#include "I3G4250D_Test.h"
+#include <math.h>
+
+bool TestAutoCalibrate(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    HAL_StatusTypeDef status;
+    float error;
+    bool restored;
+    uint8_t level;
+
+    // Z only at the low ODR, calibrated with all axes at the ultra ODR and restored afterwards
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_Z;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_245;
+    init.FIFO_MODE = I3G4250D_FIFO_MODE_STREAM;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_Sim_SetBias(100, -50, 30);
+    I3G4250D_Sim_SetNoise(20);
+    // Not a multiple of the FIFO size, the last drain is only partly used
+    status = I3G4250D_AutoCalibrate(&gyro, 300);
+    level = I3G4250D_Sim_Register(I3G4250D_FIFO_SRC_REG) & I3G4250D_FIFO_SRC_FSS;
+    error = fmaxf(TestBiasError(&gyro, gyro.X_Bias, 100), TestBiasError(&gyro, gyro.Y_Bias, -50));
+    error = fmaxf(error, TestBiasError(&gyro, gyro.Z_Bias, 30));
+    restored = I3G4250D_Sim_Register(I3G4250D_CTRL_REG1) == (I3G4250D_ODR_BW_LOW | I3G4250D_ENABLE_Z)
+            && I3G4250D_Sim_Register(I3G4250D_FIFO_CTRL_REG) == I3G4250D_FIFO_MODE_STREAM
+            && I3G4250D_Sim_Register(I3G4250D_CTRL_REG5) == I3G4250D_CTRL_REG5_FIFO_EN;
+    TestRelease(&gyro);
+
+    return TestReport(name, status == HAL_OK && error <= 2.0f && restored && level <= 1,
+                      "status %d, bias error %.2f digits, restored %d, FIFO level %u", status, error, restored, level);
+}
@@ -0,0 +1,67 @@
+/*
+CIC decimation of the DMA FIFO drains into the ring buffer, see I3G4250D_DecimatorInit.
+*/
+
+#include "I3G4250D_Test.h"
+#include <math.h>
+
+bool TestDecimator(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static I3G4250D_DataStamped stamped[I3G4250D_FIFO_SIZE];
+    I3G4250D_InitTypeDef init = {0};
+    HAL_StatusTypeDef invalid;
+    HAL_StatusTypeDef status;
+    uint32_t outputs = 0;
+    uint32_t previous = 0;
+    uint32_t spacingError = 0;
+    uint32_t rate;
+    int64_t sumZ = 0;
+    double meanZ;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_ULTRA;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.FIFO_MODE = I3G4250D_FIFO_MODE_STREAM;
+    init.FIFO_WATERMARK = 16;
+    init.DRDY_MODE = I3G4250D_DRDY_INT2_WTM;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    TestRouteInterrupts(&gyro);
+    I3G4250D_Sim_SetRate(10.0f, -20.0f, 100.0f);
+    I3G4250D_Sim_SetNoise(50);
+    // 4 * log2(32) = 20 bits of growth is too much
+    invalid = I3G4250D_DecimatorInit(&gyro, 32, 4);
+    status = I3G4250D_DecimatorInit(&gyro, 8, 3);
+
+    for (uint32_t t = 0; t < 1000; t++)
+    {
+        size_t n;
+
+        HAL_Delay(1);
+        n = I3G4250D_RingPopBlockStamped(&gyro, stamped, I3G4250D_FIFO_SIZE);
+        for (size_t i = 0; i < n; i++)
+        {
+            // The first outputs still fill the comb stages
+            if (outputs >= 3)
+            {
+                uint32_t spacing = stamped[i].timestamp - previous;
+                uint32_t expected = 8U * gyro.samplePeriod;
+                uint32_t error = spacing > expected ? spacing - expected : expected - spacing;
+
+                spacingError = error > spacingError ? error : spacingError;
+                sumZ += stamped[i].data.z;
+            }
+            previous = stamped[i].timestamp;
+            outputs++;
+        }
+    }
+    meanZ = outputs > 3 ? (double)sumZ / (double)(outputs - 3) : 0.0;
+    rate = I3G4250D_DecimatorRate(&gyro);
+    TestRelease(&gyro);
+
+    return TestReport(name, invalid == HAL_ERROR && status == HAL_OK && rate == I3G4250D_GetODR(&gyro) / 8U
+                      && outputs >= 100 && outputs <= 110 && spacingError <= gyro.samplePeriod / 4U && fabs(meanZ - 5714.0) < 10.0,
+                      "%lu outputs in 1 s, rate %lu HZ, spacing error %lu ticks, mean z %.1f", (unsigned long)outputs,
+                      (unsigned long)rate, (unsigned long)spacingError, meanZ);
+}
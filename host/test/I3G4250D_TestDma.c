@@ -0,0 +1,66 @@
+/*
+Non-blocking DMA reads with completion callback, see I3G4250D_GetRawDataDMA and I3G4250D_ReadFifoDMA.
+*/
+
+#include "I3G4250D_Test.h"
+
+static I3G4250D_DataRaw dmaLast;
+static size_t dmaCount;
+static uint32_t dmaCallbacks;
+
+static void TestDmaCallback(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *data, size_t count)
+{
+    (void)gyro;
+    dmaLast = data[count - 1];
+    dmaCount = count;
+    dmaCallbacks++;
+}
+
+bool TestDmaRead(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    HAL_StatusTypeDef status;
+    HAL_StatusTypeDef started;
+    HAL_StatusTypeDef second;
+    HAL_StatusTypeDef fifoStarted;
+    uint64_t cycles;
+    uint64_t busCycles;
+    bool busy;
+    bool single;
+    bool fifo;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    status = I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_RegisterCallback(&gyro, TestDmaCallback);
+    dmaCallbacks = 0;
+    I3G4250D_Sim_SetRate(10.0f, -20.0f, 100.0f);
+    HAL_Delay(20);
+
+    // The call only starts the 8 byte transfer, the CPU is back before the bus is done
+    cycles = I3G4250D_Sim_Cycles();
+    started = I3G4250D_GetRawDataDMA(&gyro);
+    cycles = I3G4250D_Sim_Cycles() - cycles;
+    busCycles = (8ULL * 8ULL * SystemCoreClock) / I3G4250D_GetSpiClock(&gyro);
+    busy = I3G4250D_DMABusy(&gyro) && dmaCallbacks == 0;
+    second = I3G4250D_GetRawDataDMA(&gyro);
+    HAL_Delay(1);
+    single = !I3G4250D_DMABusy(&gyro) && dmaCallbacks == 1 && dmaCount == 1
+          && dmaLast.x == 571 && dmaLast.y == -1142 && dmaLast.z == 5714;
+
+    // FIFO drains hand every stored sample to the callback at once
+    I3G4250D_SetFifoMode(&gyro, I3G4250D_FIFO_MODE_STREAM, 0);
+    HAL_Delay(100);
+    fifoStarted = I3G4250D_ReadFifoDMA(&gyro, I3G4250D_FIFO_SIZE);
+    HAL_Delay(1);
+    fifo = dmaCallbacks == 2 && dmaCount >= 8 && dmaLast.z == 5714 && (I3G4250D_Sim_Register(I3G4250D_FIFO_SRC_REG) & I3G4250D_FIFO_SRC_EMPTY);
+    TestRelease(&gyro);
+
+    return TestReport(name, status == HAL_OK && started == HAL_OK && cycles < busCycles && busy && second == HAL_BUSY && single
+                      && fifoStarted == HAL_OK && fifo,
+                      "start %lu of %lu bus cycles, busy %d, second start %d, single %d, FIFO drain of %u samples %d",
+                      (unsigned long)cycles, (unsigned long)busCycles, busy, second, single, (unsigned)dmaCount, fifo);
+}
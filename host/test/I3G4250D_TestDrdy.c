@@ -0,0 +1,56 @@
+/*
+Interrupt driven data ready on INT2, see I3G4250D_INT2_IRQHandler.
+*/
+
+#include "I3G4250D_Test.h"
+
+bool TestDataReadyInt2(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static I3G4250D_DataRaw samples[I3G4250D_RING_SIZE];
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_Sim_BusStats before;
+    I3G4250D_Sim_BusStats after;
+    HAL_StatusTypeDef status;
+    uint32_t generated;
+    uint32_t received = 0;
+    bool values = true;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_MEDIUM;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.DRDY_MODE = I3G4250D_DRDY_INT2;
+    status = I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    TestRouteInterrupts(&gyro);
+    I3G4250D_Sim_SetRate(10.0f, -20.0f, 100.0f);
+    HAL_Delay(20);
+    I3G4250D_RingPopBlock(&gyro, samples, I3G4250D_RING_SIZE);
+
+    // Every edge starts one DMA read, nothing polls STATUS_REG
+    before = I3G4250D_Sim_GetBusStats();
+    generated = I3G4250D_Sim_SamplesGenerated();
+    for (uint32_t t = 0; t < 100; t++)
+    {
+        size_t n;
+
+        HAL_Delay(10);
+        n = I3G4250D_RingPopBlock(&gyro, samples, I3G4250D_RING_SIZE);
+        for (size_t i = 0; i < n; i++)
+        {
+            values &= samples[i].x == 571 && samples[i].y == -1142 && samples[i].z == 5714;
+        }
+        received += (uint32_t)n;
+    }
+    after = I3G4250D_Sim_GetBusStats();
+    generated = I3G4250D_Sim_SamplesGenerated() - generated;
+    TestRelease(&gyro);
+
+    // A read still in flight at the end may be missing
+    return TestReport(name, status == HAL_OK && received + 1 >= generated && received <= generated && values
+                      && I3G4250D_Sim_SamplesLost() == 0 && after.dmaTransfers - before.dmaTransfers == after.transactions - before.transactions
+                      && after.transactions - before.transactions <= generated,
+                      "%lu of %lu samples in 1 s, %lu transactions, %lu by DMA, lost %lu", (unsigned long)received,
+                      (unsigned long)generated, (unsigned long)(after.transactions - before.transactions),
+                      (unsigned long)(after.dmaTransfers - before.dmaTransfers), (unsigned long)I3G4250D_Sim_SamplesLost());
+}
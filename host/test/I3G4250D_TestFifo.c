@@ -0,0 +1,63 @@
+/*
+FIFO configuration and batch drain, see I3G4250D_ReadFifo.
+*/
+
+#include "I3G4250D_Test.h"
+
+bool TestFifoDrain(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static I3G4250D_DataRaw samples[I3G4250D_FIFO_SIZE];
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_Sim_BusStats before;
+    I3G4250D_Sim_BusStats after;
+    HAL_StatusTypeDef status;
+    uint8_t source;
+    size_t n;
+    size_t partial;
+    size_t left;
+    size_t switches = 0;
+    bool values = true;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.FIFO_MODE = I3G4250D_FIFO_MODE_STREAM;
+    init.FIFO_WATERMARK = 16;
+    status = I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+
+    // About ten samples at each rate, all of them still stored
+    I3G4250D_Sim_SetRate(0.0f, 0.0f, 10.0f);
+    HAL_Delay(100);
+    I3G4250D_Sim_SetRate(0.0f, 0.0f, 100.0f);
+    HAL_Delay(100);
+    source = I3G4250D_Sim_Register(I3G4250D_FIFO_SRC_REG);
+
+    // FIFO_SRC_REG, then every stored sample in one burst that wraps at OUT_Z_H
+    before = I3G4250D_Sim_GetBusStats();
+    n = I3G4250D_ReadFifo(&gyro, samples, I3G4250D_FIFO_SIZE);
+    after = I3G4250D_Sim_GetBusStats();
+    for (size_t i = 0; i < n; i++)
+    {
+        values &= samples[i].x == 0 && samples[i].y == 0 && (samples[i].z == 571 || samples[i].z == 5714);
+        switches += (i > 0 && samples[i].z != samples[i - 1].z) ? 1U : 0U;
+    }
+
+    // A drain limited below the level leaves the rest stored
+    HAL_Delay(100);
+    partial = I3G4250D_ReadFifo(&gyro, samples, 4);
+    left = I3G4250D_Sim_Register(I3G4250D_FIFO_SRC_REG) & I3G4250D_FIFO_SRC_FSS;
+    for (size_t i = 0; i < partial; i++)
+    {
+        values &= samples[i].z == 5714;
+    }
+    TestRelease(&gyro);
+
+    return TestReport(name, status == HAL_OK && (source & I3G4250D_FIFO_SRC_WTM) && n == (source & I3G4250D_FIFO_SRC_FSS)
+                      && after.transactions - before.transactions == 2 && after.bytes - before.bytes == 2 + 1 + (6 * n)
+                      && values && switches == 1 && partial == 4 && left >= 6,
+                      "%u samples in %lu transactions of %lu bytes, values %d, rate switches %u, partial %u + %u left",
+                      (unsigned)n, (unsigned long)(after.transactions - before.transactions),
+                      (unsigned long)(after.bytes - before.bytes), values, (unsigned)switches, (unsigned)partial, (unsigned)left);
+}
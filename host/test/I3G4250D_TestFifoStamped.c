@@ -0,0 +1,47 @@
+/*
+Timestamps of the FIFO samples reconstructed back from the read, see I3G4250D_ReadFifoStamped.
+*/
+
+#include "I3G4250D_Test.h"
+
+bool TestFifoTimestamps(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static I3G4250D_DataStamped stamped[I3G4250D_FIFO_SIZE];
+    I3G4250D_InitTypeDef init = {0};
+    uint32_t previous = 0;
+    uint32_t gapError = 0;
+    size_t drained = 0;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.FIFO_MODE = I3G4250D_FIFO_MODE_STREAM;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    HAL_Delay(400);
+
+    // Drain the full FIFO a quarter at a time, the samples left behind are older than the read
+    for (uint8_t k = 0; k < 4; k++)
+    {
+        size_t n = I3G4250D_ReadFifoStamped(&gyro, stamped, I3G4250D_FIFO_SIZE / 4);
+
+        if (n > 0 && k > 0)
+        {
+            uint32_t gap = stamped[0].timestamp - previous;
+            uint32_t error = gap > gyro.samplePeriod ? gap - gyro.samplePeriod : gyro.samplePeriod - gap;
+
+            gapError = error > gapError ? error : gapError;
+        }
+        if (n > 0)
+        {
+            previous = stamped[n - 1].timestamp;
+        }
+        drained += n;
+    }
+    TestRelease(&gyro);
+
+    return TestReport(name, drained == I3G4250D_FIFO_SIZE && gapError <= gyro.samplePeriod / 4U,
+                      "%u samples in quarters, gap error %lu of %lu ticks", (unsigned)drained,
+                      (unsigned long)gapError, (unsigned long)gyro.samplePeriod);
+}
@@ -0,0 +1,71 @@
+/*
+Fixed-point scaling with the precomputed Q16.16 gain, see I3G4250D_ConvertFixed and I3G4250D_ScaleBlockFixed.
+*/
+
+#include "I3G4250D_Test.h"
+#include <math.h>
+
+#define TEST_FIXED_BLOCK                 64
+
+bool TestFixedPoint(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static const uint8_t scales[] = {I3G4250D_SCALE_245, I3G4250D_SCALE_500, I3G4250D_SCALE_2000};
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_DataRaw raw[TEST_FIXED_BLOCK];
+    I3G4250D_DataFixed block[TEST_FIXED_BLOCK];
+    double maxError = 0.0;
+    bool blockMatches = true;
+    bool initialized = true;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+
+    for (size_t s = 0; s < sizeof(scales); s++)
+    {
+        init.FULLSCALE_SELECTION = scales[s];
+        initialized &= I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init) == HAL_OK;
+
+        // A calibration with a different bias and scale on every axis
+        gyro.X_Bias = 123.4f;
+        gyro.Y_Bias = -56.7f;
+        gyro.Z_Bias = 0.0f;
+        gyro.X_Scale = 1.0f;
+        gyro.Y_Scale = 0.987f;
+        gyro.Z_Scale = 1.042f;
+        I3G4250D_UpdateGain(&gyro);
+
+        // The whole raw range in blocks, against the double precision conversion
+        for (int32_t start = INT16_MIN; start <= INT16_MAX; start += TEST_FIXED_BLOCK * 31)
+        {
+            for (size_t i = 0; i < TEST_FIXED_BLOCK; i++)
+            {
+                int32_t value = start + (int32_t)i * 31;
+                raw[i].x = (int16_t)(value > INT16_MAX ? INT16_MAX : value);
+                raw[i].y = (int16_t)-raw[i].x - 1;
+                raw[i].z = (int16_t)(raw[i].x ^ 0x5555);
+            }
+            I3G4250D_ScaleBlockFixed(&gyro, raw, block, TEST_FIXED_BLOCK);
+
+            for (size_t i = 0; i < TEST_FIXED_BLOCK; i++)
+            {
+                I3G4250D_DataFixed fixed = I3G4250D_ConvertFixed(&gyro, &raw[i]);
+                double x = raw[i].x * (double)gyro.Sensitivity * gyro.X_Scale - gyro.X_Bias;
+                double y = raw[i].y * (double)gyro.Sensitivity * gyro.Y_Scale - gyro.Y_Bias;
+                double z = raw[i].z * (double)gyro.Sensitivity * gyro.Z_Scale - gyro.Z_Bias;
+
+                blockMatches &= block[i].x == fixed.x && block[i].y == fixed.y && block[i].z == fixed.z;
+                maxError = fmax(maxError, fabs(fixed.x - x));
+                maxError = fmax(maxError, fabs(fixed.y - y));
+                maxError = fmax(maxError, fabs(fixed.z - z));
+            }
+        }
+    }
+    TestRelease(&gyro);
+
+    // Gain rounding of at most 0.5 / 65536 MDPS per digit, plus the truncating shift and the rounded offset
+    return TestReport(name, initialized && blockMatches && maxError < 2.0,
+                      "max error %.3f MDPS over the raw range at 3 full scales, block matches single conversion %d",
+                      maxError, blockMatches);
+}
@@ -0,0 +1,55 @@
+/*
+Non-blocking initialization of two gyroscopes side by side, see I3G4250D_InitStart and I3G4250D_InitStep.
+*/
+
+#include "I3G4250D_Test.h"
+
+bool TestInitStep(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static I3G4250D_HandleTypeDef gyro2;
+    SPI_HandleTypeDef fastSpi;
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_InitStateTypeDef state;
+    I3G4250D_InitStateTypeDef state2;
+    uint32_t steps = 0;
+    uint32_t start;
+    uint32_t elapsed;
+    bool configured;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+
+    // Two handles on the same bus step through the initialization side by side
+    start = HAL_GetTick();
+    I3G4250D_InitStart(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_InitStart(&gyro2, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    do
+    {
+        state = I3G4250D_InitStep(&gyro);
+        state2 = I3G4250D_InitStep(&gyro2);
+        steps++;
+        HAL_Delay(1);
+    } while (state < I3G4250D_INIT_READY || state2 < I3G4250D_INIT_READY);
+    elapsed = HAL_GetTick() - start;
+    configured = I3G4250D_Sim_Register(I3G4250D_CTRL_REG1) == (I3G4250D_ODR_BW_LOW | I3G4250D_ENABLE_ALL_AXIS)
+              && I3G4250D_Sim_Register(I3G4250D_CTRL_REG4) == ((I3G4250D_SCALE_500 >> 2) & 0x30);
+
+    // Over-clocked the WHO_AM_I reads are corrupted until the probe times out
+    fastSpi = testSpi;
+    fastSpi.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_2;
+    I3G4250D_InitStart(&gyro2, &fastSpi, GPIOC, GPIO_PIN_1, &init);
+    while (I3G4250D_InitStep(&gyro2) < I3G4250D_INIT_READY)
+    {
+        HAL_Delay(1);
+    }
+    TestRelease(&gyro);
+    TestRelease(&gyro2);
+
+    return TestReport(name, state == I3G4250D_INIT_READY && state2 == I3G4250D_INIT_READY && gyro.whoAmI == I3G4250D_WHO_AM_I_VALUE
+                      && configured && elapsed < I3G4250D_INIT_TURN_ON_TIMEOUT && gyro2.initState == I3G4250D_INIT_ERROR_ID,
+                      "ready after %lu steps in %lu ms, WHO_AM_I %02X, configured %d, over-clocked state %d",
+                      (unsigned long)steps, (unsigned long)elapsed, gyro.whoAmI, configured, gyro2.initState);
+}
@@ -0,0 +1,83 @@
+/*
+Device handles and the instance table of the SPI completion handlers, see I3G4250D_Init and I3G4250D_DeInit.
+*/
+
+#include "I3G4250D_Test.h"
+
+static uint32_t instanceCallbacks[2];
+
+static void TestInstanceCallbackA(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *data, size_t count)
+{
+    (void)gyro;
+    (void)data;
+    (void)count;
+    instanceCallbacks[0]++;
+}
+
+static void TestInstanceCallbackB(I3G4250D_HandleTypeDef *gyro, const I3G4250D_DataRaw *data, size_t count)
+{
+    (void)gyro;
+    (void)data;
+    (void)count;
+    instanceCallbacks[1]++;
+}
+
+bool TestInstances(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyros[I3G4250D_MAX_INSTANCES + 1];
+    static SPI_HandleTypeDef spiB;
+    I3G4250D_InitTypeDef init = {0};
+    uint32_t free = 0;
+    bool full;
+    bool reinitKeepsSlot;
+    bool routed;
+    HAL_StatusTypeDef busyRelease;
+    HAL_StatusTypeDef secondRelease;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+
+    // Take every slot left by the other checks, one more handle is refused
+    while (free <= I3G4250D_MAX_INSTANCES && I3G4250D_Init(&gyros[free], &testSpi, GPIOC, GPIO_PIN_1, &init) == HAL_OK)
+    {
+        free++;
+    }
+    full = free >= 2 && free <= I3G4250D_MAX_INSTANCES && gyros[free].initState == I3G4250D_INIT_ERROR_INSTANCE;
+
+    // Initialized again behind a released slot, a handle keeps its own slot instead of taking the free one as well
+    I3G4250D_DeInit(&gyros[0]);
+    reinitKeepsSlot = I3G4250D_Init(&gyros[free - 1], &testSpi, GPIOC, GPIO_PIN_1, &init) == HAL_OK
+                   && I3G4250D_Init(&gyros[free], &testSpi, GPIOC, GPIO_PIN_1, &init) == HAL_OK;
+    I3G4250D_DeInit(&gyros[free]);
+    for (uint32_t i = 2; i < free - 1; i++)
+    {
+        I3G4250D_DeInit(&gyros[i]);
+    }
+
+    // Two gyroscopes on separate buses, the completion only reaches the one that started the transfer
+    spiB = testSpi;
+    I3G4250D_Init(&gyros[0], &spiB, GPIOC, GPIO_PIN_2, &init);
+    I3G4250D_RegisterCallback(&gyros[0], TestInstanceCallbackB);
+    I3G4250D_RegisterCallback(&gyros[free - 1], TestInstanceCallbackA);
+    instanceCallbacks[0] = 0;
+    instanceCallbacks[1] = 0;
+    HAL_Delay(20);
+    I3G4250D_GetRawDataDMA(&gyros[0]);
+    busyRelease = I3G4250D_DeInit(&gyros[0]);
+    HAL_Delay(1);
+    routed = instanceCallbacks[0] == 0 && instanceCallbacks[1] == 1;
+    I3G4250D_GetRawDataDMA(&gyros[free - 1]);
+    HAL_Delay(1);
+    routed &= instanceCallbacks[0] == 1 && instanceCallbacks[1] == 1;
+
+    I3G4250D_DeInit(&gyros[0]);
+    I3G4250D_DeInit(&gyros[1]);
+    I3G4250D_DeInit(&gyros[free - 1]);
+    secondRelease = I3G4250D_DeInit(&gyros[free - 1]);
+
+    return TestReport(name, full && reinitKeepsSlot && routed && busyRelease == HAL_BUSY && secondRelease == HAL_ERROR,
+                      "%lu free slots, full %d, re-initialized handle keeps its slot %d, completions routed %d, release busy %d twice %d",
+                      (unsigned long)free, full, reinitKeepsSlot, routed, busyRelease, secondRelease);
+}
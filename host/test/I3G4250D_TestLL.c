@@ -0,0 +1,57 @@
+/*
+Register level SPI backend on a fake SPI peripheral, see I3G4250D_LL.h.
+The backend refuses the host build, so it is included here without I3G4250D_HOST and only its transfer and chip select
+functions are checked, the driver itself keeps the simulated HAL bus.
+*/
+
+#include "I3G4250D_Test.h"
+
+// STM32F4 SPI_CR1 / SPI_SR bits used by the backend
+#define SPI_CR1_SPE                      (1U << 6)
+#define SPI_SR_RXNE                      (1U << 0)
+#define SPI_SR_TXE                       (1U << 1)
+#define SPI_SR_OVR                       (1U << 6)
+
+#undef I3G4250D_HOST
+#undef I3G4250D_BUS_TRANSMIT
+#undef I3G4250D_BUS_RECEIVE
+#undef I3G4250D_BUS_TRANSFER
+#undef I3G4250D_CS_WRITE
+#include "I3G4250D_LL.h"
+
+bool TestLLTransfer(const char *name)
+{
+    static SPI_TypeDef spi;
+    static GPIO_TypeDef port;
+    SPI_HandleTypeDef hspi = {0};
+    uint8_t frame[4] = {0x11, 0x22, 0x33, 0x44};
+    HAL_StatusTypeDef stalled;
+    HAL_StatusTypeDef idle;
+    uint32_t stalledDr;
+    bool chipSelect;
+
+    hspi.Instance = &spi;
+
+    // TXE without RXNE: two bytes go into the pipeline, then the missing receive times out after the spin limit
+    spi.CR1 = 0;
+    spi.SR = SPI_SR_TXE;
+    spi.DR = 0;
+    stalled = I3G4250D_LL_Transfer(&hspi, frame, frame, sizeof(frame));
+    stalledDr = spi.DR;
+
+    // Neither flag: nothing is loaded at all
+    spi.SR = 0;
+    spi.DR = 0xA5;
+    idle = I3G4250D_LL_Transfer(&hspi, frame, NULL, sizeof(frame));
+
+    // Chip select in one BSRR store, the reset half for active low
+    I3G4250D_LL_CsWrite(&port, GPIO_PIN_3, GPIO_PIN_RESET);
+    chipSelect = port.BSRR == ((uint32_t)GPIO_PIN_3 << 16);
+    I3G4250D_LL_CsWrite(&port, GPIO_PIN_3, GPIO_PIN_SET);
+    chipSelect &= port.BSRR == GPIO_PIN_3;
+
+    return TestReport(name, stalled == HAL_TIMEOUT && (spi.CR1 & SPI_CR1_SPE) && stalledDr == 0x22 && frame[0] == 0x11
+                      && idle == HAL_TIMEOUT && spi.DR == 0xA5 && chipSelect,
+                      "stalled %d with DR 0x%02lX, idle %d with DR 0x%02lX, chip select %d",
+                      stalled, (unsigned long)stalledDr, idle, (unsigned long)spi.DR, chipSelect);
+}
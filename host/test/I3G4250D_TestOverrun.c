@@ -0,0 +1,86 @@
+/*
+Overrun accounting of the polled and FIFO read paths against the samples the simulator overwrote, see I3G4250D_GetOverruns.
+*/
+
+#include "I3G4250D_Test.h"
+
+static uint32_t overrunCalls;
+static uint8_t overrunFlags;
+
+static void TestOverrunCallback(I3G4250D_HandleTypeDef *gyro, uint8_t flags, uint32_t lost)
+{
+    (void)gyro;
+    (void)lost;
+    overrunCalls++;
+    overrunFlags |= flags;
+}
+
+bool TestOverruns(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static I3G4250D_DataRaw raw[I3G4250D_FIFO_SIZE];
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_OverrunTypeDef polled;
+    I3G4250D_OverrunTypeDef fifo;
+    uint32_t lostBefore;
+    uint32_t polledLost;
+    uint32_t fifoLost;
+    bool inTime;
+    bool bypass;
+    bool stream;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_MEDIUM;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_RegisterOverrunCallback(&gyro, TestOverrunCallback);
+    I3G4250D_ResetOverruns(&gyro);
+    overrunCalls = 0;
+    overrunFlags = 0;
+
+    // Read in time nothing is lost or counted
+    lostBefore = I3G4250D_Sim_SamplesLost();
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        if (I3G4250D_DataReady(&gyro, 10))
+        {
+            I3G4250D_GetRawData(&gyro);
+        }
+    }
+    I3G4250D_GetOverruns(&gyro, &polled);
+    inTime = I3G4250D_Sim_SamplesLost() == lostBefore && polled.events == 0 && overrunCalls == 0;
+
+    // Five late reads, each seen by I3G4250D_DataReady and the read after it but counted once, one sample per axis at least
+    lostBefore = I3G4250D_Sim_SamplesLost();
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        HAL_Delay(20);
+        if (I3G4250D_DataReady(&gyro, 10))
+        {
+            I3G4250D_GetRawData(&gyro);
+        }
+    }
+    polledLost = I3G4250D_Sim_SamplesLost() - lostBefore;
+    I3G4250D_GetOverruns(&gyro, &polled);
+    bypass = polled.events == 5 && overrunCalls == 5 && polled.x == 5 && polled.y == 5 && polled.z == 5
+          && polledLost >= 5 && (overrunFlags & I3G4250D_STATUS_OVERRUN) == I3G4250D_STATUS_OVERRUN;
+
+    // A full stream FIFO estimates the loss from the time since the previous drain
+    I3G4250D_SetFifoMode(&gyro, I3G4250D_FIFO_MODE_STREAM, 0);
+    HAL_Delay(5);
+    I3G4250D_ReadFifo(&gyro, raw, I3G4250D_FIFO_SIZE);
+    I3G4250D_ResetOverruns(&gyro);
+    lostBefore = I3G4250D_Sim_SamplesLost();
+    HAL_Delay(500);
+    I3G4250D_ReadFifo(&gyro, raw, I3G4250D_FIFO_SIZE);
+    fifoLost = I3G4250D_Sim_SamplesLost() - lostBefore;
+    I3G4250D_GetOverruns(&gyro, &fifo);
+    stream = fifo.events == 1 && fifoLost > 0 && fifo.z + 2 >= fifoLost && fifo.z <= fifoLost + 2 && fifo.x == fifo.z;
+    TestRelease(&gyro);
+
+    return TestReport(name, inTime && bypass && stream,
+                      "in time %d, polled %lu events %lu lost of %lu, FIFO %lu lost of %lu",
+                      inTime, (unsigned long)polled.events, (unsigned long)polled.x, (unsigned long)polledLost,
+                      (unsigned long)fifo.z, (unsigned long)fifoLost);
+}
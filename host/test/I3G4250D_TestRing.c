@@ -0,0 +1,70 @@
+/*
+Lock-free sample ring buffer between the completion interrupt and the application, see I3G4250D_RingPopBlock.
+*/
+
+#include "I3G4250D_Test.h"
+
+bool TestRingBuffer(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static I3G4250D_DataStamped samples[I3G4250D_RING_SIZE];
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_Sim_BusStats before;
+    HAL_StatusTypeDef status;
+    uint32_t delivered;
+    uint32_t overflows;
+    uint32_t previous = 0;
+    uint32_t gapError = 0;
+    uint32_t popped = 0;
+    size_t stored;
+    size_t n;
+    bool oldestKept;
+    bool started = false;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_MEDIUM;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.DRDY_MODE = I3G4250D_DRDY_INT2;
+    status = I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    before = I3G4250D_Sim_GetBusStats();
+    TestRouteInterrupts(&gyro);
+
+    // Nobody pops for a second, the ring keeps the first I3G4250D_RING_SIZE samples and counts the rest
+    I3G4250D_Sim_SetRate(0.0f, 0.0f, 10.0f);
+    HAL_Delay(100);
+    I3G4250D_Sim_SetRate(0.0f, 0.0f, 100.0f);
+    HAL_Delay(900);
+    stored = I3G4250D_RingCount(&gyro);
+    overflows = I3G4250D_RingOverflows(&gyro);
+    delivered = I3G4250D_Sim_GetBusStats().dmaTransfers - (before.dmaTransfers + (I3G4250D_DMABusy(&gyro) ? 1U : 0U));
+    n = I3G4250D_RingPopBlockStamped(&gyro, samples, I3G4250D_RING_SIZE);
+    oldestKept = n == I3G4250D_RING_SIZE && samples[0].data.z == 571 && samples[n - 1].data.z == 5714;
+
+    // Popping in odd chunks wraps head and tail many times, the timestamps stay one sample period apart
+    for (uint32_t t = 0; t < 200; t++)
+    {
+        HAL_Delay(5);
+        n = I3G4250D_RingPopBlockStamped(&gyro, samples, 7);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (started)
+            {
+                uint32_t gap = samples[i].timestamp - previous;
+                uint32_t error = gap > gyro.samplePeriod ? gap - gyro.samplePeriod : gyro.samplePeriod - gap;
+
+                gapError = error > gapError ? error : gapError;
+            }
+            previous = samples[i].timestamp;
+            started = true;
+        }
+        popped += (uint32_t)n;
+    }
+    TestRelease(&gyro);
+
+    return TestReport(name, status == HAL_OK && stored == I3G4250D_RING_SIZE && overflows + I3G4250D_RING_SIZE == delivered
+                      && oldestKept && popped >= 200 && I3G4250D_RingOverflows(&gyro) == overflows && gapError <= gyro.samplePeriod / 4U,
+                      "%u stored, %lu overflows of %lu delivered, oldest kept %d, %lu popped in chunks, gap error %lu ticks",
+                      (unsigned)stored, (unsigned long)overflows, (unsigned long)delivered, oldestKept, (unsigned long)popped,
+                      (unsigned long)gapError);
+}
@@ -0,0 +1,75 @@
+/*
+Block conversion kernels, see I3G4250D_ScaleBlock and I3G4250D_ScaleBlockQ15.
+*/
+
+#include "I3G4250D_Test.h"
+#include <math.h>
+
+#define TEST_SCALE_BLOCK                 63                    // Odd, so the two sample kernel also leaves a tail
+
+// Bias corrected and scaled digits, saturating the product and then the offset subtraction like the q15 kernel
+static double TestScaleReference(int16_t raw, float scale, float bias, float sensitivity)
+{
+    double value = fmin(fmax(raw * (double)scale, INT16_MIN), INT16_MAX);
+    value -= round(bias / (double)sensitivity);
+    return fmin(fmax(value, INT16_MIN), INT16_MAX);
+}
+
+bool TestScaleBlock(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static const float scales[] = {0.95f, 1.0f, 1.042f, 1.9f};
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_DataRaw raw[TEST_SCALE_BLOCK];
+    I3G4250D_DataRaw q15[TEST_SCALE_BLOCK];
+    I3G4250D_DataScaled scaled[TEST_SCALE_BLOCK];
+    double maxError = 0.0;
+    bool floatMatches = true;
+    HAL_StatusTypeDef status;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    status = I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+
+    for (size_t s = 0; s < sizeof(scales) / sizeof(scales[0]); s++)
+    {
+        // Scales on both sides of the shared q15 shift
+        gyro.X_Bias = 250.0f;
+        gyro.Y_Bias = -87.5f;
+        gyro.Z_Bias = 3.0f;
+        gyro.X_Scale = scales[s];
+        gyro.Y_Scale = 1.0f;
+        gyro.Z_Scale = scales[s] * 0.9f;
+        I3G4250D_UpdateGain(&gyro);
+
+        for (int32_t start = INT16_MIN; start <= INT16_MAX; start += TEST_SCALE_BLOCK * 37)
+        {
+            for (size_t i = 0; i < TEST_SCALE_BLOCK; i++)
+            {
+                int32_t value = start + (int32_t)i * 37;
+                raw[i].x = (int16_t)(value > INT16_MAX ? INT16_MAX : value);
+                raw[i].y = (int16_t)(raw[i].x / 3);
+                raw[i].z = (int16_t)-raw[i].x - 1;
+            }
+            I3G4250D_ScaleBlockQ15(&gyro, raw, q15, TEST_SCALE_BLOCK);
+            I3G4250D_ScaleBlock(&gyro, raw, scaled, TEST_SCALE_BLOCK);
+
+            for (size_t i = 0; i < TEST_SCALE_BLOCK; i++)
+            {
+                I3G4250D_DataScaled single = I3G4250D_ConvertScaled(&gyro, &raw[i]);
+
+                floatMatches &= scaled[i].x == single.x && scaled[i].y == single.y && scaled[i].z == single.z;
+                maxError = fmax(maxError, fabs(q15[i].x - TestScaleReference(raw[i].x, gyro.X_Scale, gyro.X_Bias, gyro.Sensitivity)));
+                maxError = fmax(maxError, fabs(q15[i].y - TestScaleReference(raw[i].y, gyro.Y_Scale, gyro.Y_Bias, gyro.Sensitivity)));
+                maxError = fmax(maxError, fabs(q15[i].z - TestScaleReference(raw[i].z, gyro.Z_Scale, gyro.Z_Bias, gyro.Sensitivity)));
+            }
+        }
+    }
+    TestRelease(&gyro);
+
+    return TestReport(name, status == HAL_OK && floatMatches && maxError <= 2.0,
+                      "q15 max error %.2f digits over the raw range at 4 scales, float block matches single conversion %d",
+                      maxError, floatMatches);
+}
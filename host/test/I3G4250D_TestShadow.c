@@ -0,0 +1,98 @@
+/*
+Shadow register cache and minimal configuration writes, see I3G4250D_WriteRegisters and I3G4250D_Configure.
+*/
+
+#include "I3G4250D_Test.h"
+
+// Bytes clocked on the bus since the previous call
+static uint32_t TestShadowBytes(void)
+{
+    static uint64_t mark;
+    uint64_t bytes = I3G4250D_Sim_GetBusStats().bytes;
+    uint32_t delta = (uint32_t)(bytes - mark);
+
+    mark = bytes;
+    return delta;
+}
+
+// Simulated CTRL_REG1..CTRL_REG5 equal to the shadow
+static bool TestShadowInSync(const I3G4250D_HandleTypeDef *gyro)
+{
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        if (I3G4250D_Sim_Register(I3G4250D_CTRL_REG1 + i) != gyro->shadow[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TestShadowRegisters(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    uint8_t ctrl[3];
+    uint32_t unchanged;
+    uint32_t single;
+    uint32_t span;
+    uint32_t rewritten;
+    bool minimal;
+    bool stale;
+    bool initFails;
+    uint32_t retries = 0;
+    I3G4250D_InitStateTypeDef state;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+
+    TestShadowBytes();
+
+    // Unchanged values cost nothing, a changed register is written alone and two changes share one span
+    I3G4250D_WriteRegister(&gyro, I3G4250D_CTRL_REG4, gyro.shadow[3]);
+    unchanged = TestShadowBytes();
+    I3G4250D_SetFullScale(&gyro, I3G4250D_SCALE_2000);
+    single = TestShadowBytes();
+    ctrl[0] = gyro.shadow[0] ^ 0x01;
+    ctrl[1] = gyro.shadow[1];
+    ctrl[2] = gyro.shadow[2] ^ 0x04;
+    I3G4250D_WriteRegisters(&gyro, I3G4250D_CTRL_REG1, ctrl, 3);
+    span = TestShadowBytes();
+    minimal = unchanged == 0 && single == 2 && span == 4 && TestShadowInSync(&gyro);
+
+    // A failed write keeps the cached value but marks it stale, so writing that value again goes to the bus
+    I3G4250D_Sim_SetBusErrors(1);
+    stale = I3G4250D_WriteRegister(&gyro, I3G4250D_CTRL_REG3, gyro.shadow[2] ^ 0x08) == HAL_ERROR && gyro.shadowStale == 0x04;
+    TestShadowBytes();
+    I3G4250D_WriteRegister(&gyro, I3G4250D_CTRL_REG3, gyro.shadow[2]);
+    rewritten = TestShadowBytes();
+    stale &= rewritten == 2 && gyro.shadowStale == 0 && TestShadowInSync(&gyro);
+
+    // The blocking initialization reports the failed configuration
+    I3G4250D_Sim_SetBusErrors(UINT32_MAX);
+    initFails = I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init) == HAL_ERROR
+             && gyro.initState == I3G4250D_INIT_ERROR_CONFIGURE;
+    I3G4250D_Sim_SetBusErrors(0);
+
+    // The non-blocking one retries the configuration and rewrites every stale register
+    I3G4250D_InitStart(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    while ((state = I3G4250D_InitStep(&gyro)) == I3G4250D_INIT_PROBE)
+    {
+        HAL_Delay(1);
+    }
+    I3G4250D_Sim_SetBusErrors(3);
+    while ((state = I3G4250D_InitStep(&gyro)) < I3G4250D_INIT_READY)
+    {
+        retries += state == I3G4250D_INIT_CONFIGURE;
+        HAL_Delay(1);
+    }
+    TestRelease(&gyro);
+
+    return TestReport(name, minimal && stale && initFails && retries > 0 && state == I3G4250D_INIT_READY && TestShadowInSync(&gyro),
+                      "%lu / %lu / %lu bytes for 0 / 1 / 2 changes, stale rewrite %lu bytes, init error %d, %lu configure retries, state %d",
+                      (unsigned long)unchanged, (unsigned long)single, (unsigned long)span, (unsigned long)rewritten,
+                      initFails, (unsigned long)retries, state);
+}
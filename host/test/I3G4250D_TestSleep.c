@@ -0,0 +1,83 @@
+/*
+Sleep on the INT1 wakeup threshold and the deferred wakeup, see I3G4250D_EnterSleep and I3G4250D_WakeService.
+*/
+
+#include "I3G4250D_Test.h"
+
+static uint32_t sleepWakeups;
+
+static void TestWakeCallback(I3G4250D_HandleTypeDef *gyro, uint8_t source)
+{
+    (void)gyro;
+    (void)source;
+    sleepWakeups++;
+}
+
+bool TestSleepWake(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    static I3G4250D_DataRaw raw[I3G4250D_RING_SIZE];
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_Sim_BusStats before;
+    uint32_t sleepTransactions;
+    uint32_t streamed;
+    uint32_t asleep = 0;
+    uint32_t resumed = 0;
+    bool sleepRegisters;
+    bool shortBump;
+    bool deferred;
+    bool wakeRegisters;
+    bool awake;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_ULTRA;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.DRDY_MODE = I3G4250D_DRDY_INT2;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    TestRouteInterrupts(&gyro);
+    I3G4250D_Sim_SetNoise(3);
+    sleepWakeups = 0;
+    I3G4250D_RegisterWakeCallback(&gyro, TestWakeCallback);
+    I3G4250D_ConfigureWakeup(&gyro, 10000, I3G4250D_WAKE_ALL_AXIS, 50, false);
+    HAL_Delay(100);
+    streamed = (uint32_t)I3G4250D_RingPopBlock(&gyro, raw, I3G4250D_RING_SIZE);
+
+    // Lowest ODR with the axes kept, INT2 off, INT1 armed and the FIFO bypassed
+    I3G4250D_EnterSleep(&gyro);
+    sleepRegisters = I3G4250D_Sim_Register(I3G4250D_CTRL_REG1) == (I3G4250D_ODR_BW_LOW | I3G4250D_ENABLE_ALL_AXIS)
+                  && I3G4250D_Sim_Register(I3G4250D_CTRL_REG3) == I3G4250D_CTRL_REG3_I1_INT1
+                  && (I3G4250D_Sim_Register(I3G4250D_CTRL_REG5) & I3G4250D_CTRL_REG5_FIFO_EN) == 0
+                  && I3G4250D_Sim_Register(I3G4250D_FIFO_CTRL_REG) == I3G4250D_FIFO_MODE_BYPASS
+                  && I3G4250D_Sim_Register(I3G4250D_INT1_CFG_REG) == gyro.wakeConfig;
+
+    // Standing still and a bump shorter than the duration leave the bus idle
+    before = I3G4250D_Sim_GetBusStats();
+    HAL_Delay(500);
+    I3G4250D_Sim_SetRate(0.0f, 0.0f, 50.0f);
+    HAL_Delay(20);
+    I3G4250D_Sim_SetRate(0.0f, 0.0f, 0.0f);
+    HAL_Delay(200);
+    sleepTransactions = I3G4250D_Sim_GetBusStats().transactions - before.transactions;
+    asleep = (uint32_t)I3G4250D_RingPopBlock(&gyro, raw, I3G4250D_RING_SIZE);
+    shortBump = I3G4250D_IsSleeping(&gyro) && sleepWakeups == 0;
+
+    // Lasting motion only marks the wakeup in the interrupt, the service wakes the gyroscope into the streaming configuration
+    I3G4250D_Sim_SetRate(0.0f, 0.0f, 50.0f);
+    HAL_Delay(200);
+    deferred = I3G4250D_IsSleeping(&gyro) && gyro.wakePending && sleepWakeups == 0;
+    deferred = deferred && I3G4250D_WakeService(&gyro) && !gyro.wakePending;
+    I3G4250D_RingPopBlock(&gyro, raw, I3G4250D_RING_SIZE);
+    HAL_Delay(100);
+    resumed = (uint32_t)I3G4250D_RingPopBlock(&gyro, raw, I3G4250D_RING_SIZE);
+    wakeRegisters = I3G4250D_Sim_Register(I3G4250D_CTRL_REG1) == (I3G4250D_ODR_BW_ULTRA | I3G4250D_ENABLE_ALL_AXIS)
+                 && I3G4250D_Sim_Register(I3G4250D_CTRL_REG3) == I3G4250D_CTRL_REG3_I2_DRDY
+                 && I3G4250D_Sim_Register(I3G4250D_INT1_CFG_REG) == 0;
+    awake = !I3G4250D_IsSleeping(&gyro);
+    TestRelease(&gyro);
+
+    return TestReport(name, streamed > 0 && sleepRegisters && shortBump && sleepTransactions == 0 && asleep == 0 && deferred
+                      && sleepWakeups == 1 && awake && wakeRegisters && resumed > 0,
+                      "sleep registers %d, %lu transactions asleep, deferred %d, wakeups %lu, wake registers %d, %lu samples after",
+                      sleepRegisters, (unsigned long)sleepTransactions, deferred, (unsigned long)sleepWakeups, wakeRegisters, (unsigned long)resumed);
+}
@@ -0,0 +1,67 @@
+/*
+Driver instrumentation counters against the bus traffic seen by the simulator, see I3G4250D_GetStats.
+The test build defines I3G4250D_ENABLE_STATS.
+*/
+
+#include "I3G4250D_Test.h"
+
+bool TestStats(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_Sim_BusStats before;
+    I3G4250D_Sim_BusStats after;
+    I3G4250D_StatsTypeDef stats;
+    I3G4250D_StatsTypeDef failed;
+    uint32_t samples = 0;
+    uint32_t minCycles;
+    uint32_t average;
+    bool counted;
+    bool timed;
+    bool errors;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_LOW;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_ResetStats(&gyro);
+    before = I3G4250D_Sim_GetBusStats();
+
+    // Polled reads for a second and a half, every STATUS_REG poll and sample burst is one read transaction
+    for (uint32_t attempt = 0; attempt < 400 && samples < 160; attempt++)
+    {
+        if (I3G4250D_DataReady(&gyro, 20))
+        {
+            I3G4250D_GetRawData(&gyro);
+            samples++;
+        }
+    }
+    I3G4250D_SetFullScale(&gyro, I3G4250D_SCALE_2000);
+    after = I3G4250D_Sim_GetBusStats();
+    I3G4250D_GetStats(&gyro, &stats);
+    counted = stats.samplesDelivered == samples && stats.read.count + stats.write.count == after.transactions - before.transactions
+           && stats.write.count == 1 && stats.pollIterations >= samples
+           && stats.samplesPerSecond >= 100 && stats.samplesPerSecond <= 110;
+
+    // The shortest read is a 2 byte STATUS_REG poll, 16 SPI clocks of 32 core cycles at SPI_BAUDRATEPRESCALER_16
+    minCycles = 2U * 8U * 32U;
+    average = I3G4250D_StatsAverageCycles(&stats.read);
+    timed = stats.read.cyclesMin >= minCycles && stats.read.cyclesMin <= average && average <= stats.read.cyclesMax;
+
+    // Failed transfers are counted, but deliver no sample
+    I3G4250D_Sim_SetBusErrors(2);
+    I3G4250D_GetRawData(&gyro);
+    I3G4250D_GetRawData(&gyro);
+    I3G4250D_GetStats(&gyro, &failed);
+    errors = failed.spiErrors == stats.spiErrors + 2 && failed.samplesDelivered == stats.samplesDelivered
+          && failed.read.count == stats.read.count + 2;
+    TestRelease(&gyro);
+
+    return TestReport(name, counted && timed && errors,
+                      "%lu samples at %lu per second, %lu + %lu transactions of %lu, read cycles %lu..%lu, errors %lu",
+                      (unsigned long)stats.samplesDelivered, (unsigned long)stats.samplesPerSecond,
+                      (unsigned long)stats.read.count, (unsigned long)stats.write.count,
+                      (unsigned long)(after.transactions - before.transactions), (unsigned long)stats.read.cyclesMin,
+                      (unsigned long)stats.read.cyclesMax, (unsigned long)(failed.spiErrors - stats.spiErrors));
+}
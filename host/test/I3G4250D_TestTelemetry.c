@@ -0,0 +1,101 @@
+/*
+Telemetry packets encoded and decoded in process, see I3G4250D_TelemetryEncode and I3G4250D_TelemetryDecodeByte.
+*/
+
+#include "I3G4250D_Test.h"
+#include "I3G4250D_Telemetry.h"
+#include <string.h>
+
+// Feed a packet to the decoder, returns the number of packets that passed the CRC
+static uint32_t TestTelemetryFeed(I3G4250D_TelemetryDecoderTypeDef *decoder, const uint8_t *bytes, size_t size,
+                                  I3G4250D_TelemetryPacketTypeDef *packet)
+{
+    uint32_t decoded = 0;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        decoded += I3G4250D_TelemetryDecodeByte(decoder, bytes[i], packet) ? 1U : 0U;
+    }
+    return decoded;
+}
+
+// Decoded packet equal to what was encoded
+static bool TestTelemetryMatches(const I3G4250D_TelemetryPacketTypeDef *packet, const I3G4250D_DataRaw *samples, size_t n,
+                                 uint32_t timestamp, uint32_t period)
+{
+    return packet->count == n && packet->timestamp == timestamp && packet->period == period
+        && memcmp(packet->samples, samples, n * sizeof(I3G4250D_DataRaw)) == 0;
+}
+
+bool TestTelemetry(const char *name)
+{
+    static I3G4250D_TelemetryEncoderTypeDef encoder;
+    static I3G4250D_TelemetryDecoderTypeDef decoder;
+    static I3G4250D_TelemetryPacketTypeDef packet;
+    static uint8_t copies[3][I3G4250D_TELEMETRY_PACKET_MAX];
+    I3G4250D_DataRaw smooth[I3G4250D_TELEMETRY_MAX_SAMPLES];
+    I3G4250D_DataRaw jumps[I3G4250D_TELEMETRY_MAX_SAMPLES];
+    const uint8_t *first;
+    const uint8_t *second;
+    const uint8_t *third;
+    size_t smoothSize;
+    size_t jumpSize;
+    size_t singleSize;
+    size_t busySize;
+    size_t corruptSize;
+    uint8_t noise[5] = {0xA5, 0x00, 0xA5, 0x5A, 0xFF};
+    bool roundTrip = true;
+    bool resync;
+
+    // A slow turn with noise, and full scale jumps that only round trip modulo 2^16
+    for (size_t i = 0; i < I3G4250D_TELEMETRY_MAX_SAMPLES; i++)
+    {
+        smooth[i].x = (int16_t)(100 + (int16_t)i * 3 + (int16_t)(i % 3));
+        smooth[i].y = (int16_t)(-2000 - (int16_t)i);
+        smooth[i].z = (int16_t)(5714 + (int16_t)(i & 1));
+        jumps[i].x = (i & 1) ? INT16_MAX : INT16_MIN;
+        jumps[i].y = (int16_t)(i * 2053);
+        jumps[i].z = 0;
+    }
+
+    I3G4250D_TelemetryEncoderInit(&encoder);
+    I3G4250D_TelemetryDecoderInit(&decoder);
+
+    // Two packets in flight, a third one has no buffer and its samples are counted as dropped
+    smoothSize = I3G4250D_TelemetryEncode(&encoder, smooth, I3G4250D_TELEMETRY_MAX_SAMPLES, 1000, 214285, &first);
+    jumpSize = I3G4250D_TelemetryEncode(&encoder, jumps, I3G4250D_TELEMETRY_MAX_SAMPLES, 0xFFFFFFF0U, 0xFFFFFFFFU, &second);
+    busySize = I3G4250D_TelemetryEncode(&encoder, smooth, 1, 0, 1, &third);
+    memcpy(copies[0], first, smoothSize);
+    memcpy(copies[1], second, jumpSize);
+    I3G4250D_TelemetryRelease(&encoder, first);
+    I3G4250D_TelemetryRelease(&encoder, second);
+    singleSize = I3G4250D_TelemetryEncode(&encoder, &jumps[1], 1, 42, 1, &third);
+    memcpy(copies[2], third, singleSize);
+    I3G4250D_TelemetryRelease(&encoder, third);
+
+    roundTrip &= TestTelemetryFeed(&decoder, copies[0], smoothSize, &packet) == 1
+              && TestTelemetryMatches(&packet, smooth, I3G4250D_TELEMETRY_MAX_SAMPLES, 1000, 214285) && packet.sequence == 0;
+    roundTrip &= TestTelemetryFeed(&decoder, copies[1], jumpSize, &packet) == 1
+              && TestTelemetryMatches(&packet, jumps, I3G4250D_TELEMETRY_MAX_SAMPLES, 0xFFFFFFF0U, 0xFFFFFFFFU);
+    roundTrip &= TestTelemetryFeed(&decoder, copies[2], singleSize, &packet) == 1
+              && TestTelemetryMatches(&packet, &jumps[1], 1, 42, 1);
+
+    // Noise, a corrupted packet and then an intact one: only the last is decoded, the corrupted one shows as a gap
+    corruptSize = I3G4250D_TelemetryEncode(&encoder, smooth, 8, 7, 9, &first);
+    memcpy(copies[0], first, corruptSize);
+    I3G4250D_TelemetryRelease(&encoder, first);
+    copies[0][I3G4250D_TELEMETRY_HEADER_SIZE + 3] ^= 0x10;
+    singleSize = I3G4250D_TelemetryEncode(&encoder, smooth, 4, 8, 9, &first);
+    memcpy(copies[1], first, singleSize);
+    I3G4250D_TelemetryRelease(&encoder, first);
+    resync = TestTelemetryFeed(&decoder, noise, sizeof(noise), &packet) == 0
+          && TestTelemetryFeed(&decoder, copies[0], corruptSize, &packet) == 0
+          && TestTelemetryFeed(&decoder, copies[1], singleSize, &packet) == 1
+          && TestTelemetryMatches(&packet, smooth, 4, 8, 9) && decoder.crcErrors >= 1 && decoder.lostPackets == 1
+          && decoder.packets == 4;
+
+    return TestReport(name, roundTrip && resync && busySize == 0 && encoder.dropped == 1 && smoothSize <= 90,
+                      "%lu and %lu byte packets round trip %d, busy %lu dropped %lu, resync %d, %lu CRC errors, %lu lost",
+                      (unsigned long)smoothSize, (unsigned long)jumpSize, roundTrip, (unsigned long)busySize,
+                      (unsigned long)encoder.dropped, resync, (unsigned long)decoder.crcErrors, (unsigned long)decoder.lostPackets);
+}
@@ -0,0 +1,54 @@
+/*
+Temperature compensation of the bias from a calibration table, see I3G4250D_TempCompInit.
+*/
+
+#include "I3G4250D_Test.h"
+#include <math.h>
+
+bool TestTempComp(const char *name)
+{
+    static const I3G4250D_TempBiasTypeDef table[] = {{-20, 350, -175, 700}, {25, 0, 0, 0}, {70, -700, 350, 1400}};
+    static const int8_t temperatures[] = {-30, -20, 0, 25, 47, 70, 80};
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    float error = 0.0f;
+    bool tracked = true;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_HIGH;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+    I3G4250D_TempCompInit(&gyro, table, sizeof(table) / sizeof(table[0]));
+
+    for (size_t k = 0; k < sizeof(temperatures) / sizeof(temperatures[0]); k++)
+    {
+        int8_t temperature = temperatures[k];
+        size_t upper = 1;
+        float fraction;
+        float expected[3];
+
+        // Held constant beyond both ends of the table, linear in between
+        while (upper < (sizeof(table) / sizeof(table[0])) - 1 && temperature > table[upper].temperature)
+        {
+            upper++;
+        }
+        fraction = (float)(temperature - table[upper - 1].temperature) / (float)(table[upper].temperature - table[upper - 1].temperature);
+        fraction = fminf(fmaxf(fraction, 0.0f), 1.0f);
+        expected[0] = table[upper - 1].x + fraction * (float)(table[upper].x - table[upper - 1].x);
+        expected[1] = table[upper - 1].y + fraction * (float)(table[upper].y - table[upper - 1].y);
+        expected[2] = table[upper - 1].z + fraction * (float)(table[upper].z - table[upper - 1].z);
+
+        I3G4250D_Sim_SetTemperature((int8_t)(I3G4250D_TEMP_OFFSET - temperature));
+        HAL_Delay(5);
+        I3G4250D_GetRawData(&gyro);
+        tracked &= gyro.tempComp.temperature == temperature;
+        error = fmaxf(error, fabsf(gyro.X_Bias - expected[0]));
+        error = fmaxf(error, fabsf(gyro.Y_Bias - expected[1]));
+        error = fmaxf(error, fabsf(gyro.Z_Bias - expected[2]));
+    }
+    TestRelease(&gyro);
+
+    return TestReport(name, tracked && error <= 1.0f, "%u temperatures tracked %d, bias error %.2f MDPS",
+                      (unsigned)(sizeof(temperatures) / sizeof(temperatures[0])), tracked, error);
+}
@@ -0,0 +1,44 @@
+/*
+In place full-duplex transactions, see I3G4250D_TransferIO.
+*/
+
+#include "I3G4250D_Test.h"
+
+bool TestTransferIO(const char *name)
+{
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    I3G4250D_Sim_BusStats before;
+    I3G4250D_Sim_BusStats after;
+    uint8_t frame[6] = {I3G4250D_CTRL_REG1 | I3G4250D_SPI_READ | I3G4250D_SPI_AUTO_INCREMENT, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE};
+    uint8_t write[3] = {I3G4250D_INT1_THS_XH_REG | I3G4250D_SPI_AUTO_INCREMENT, 0x12, 0x34};
+    HAL_StatusTypeDef readStatus;
+    HAL_StatusTypeDef writeStatus;
+    bool readMatches = true;
+    bool written;
+
+    TestReset();
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_MEDIUM;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_2000;
+    I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+
+    // CTRL_REG1..CTRL_REG5 come back in the frame that carried the address, in one chip select
+    before = I3G4250D_Sim_GetBusStats();
+    readStatus = I3G4250D_TransferIO(&gyro, frame, sizeof(frame));
+    after = I3G4250D_Sim_GetBusStats();
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        readMatches &= frame[1 + i] == gyro.shadow[i] && frame[1 + i] == I3G4250D_Sim_Register(I3G4250D_CTRL_REG1 + i);
+    }
+    readMatches &= after.transactions - before.transactions == 1 && after.bytes - before.bytes == sizeof(frame);
+
+    // Without the read bit the data bytes are written, the auto increment covers both threshold registers
+    writeStatus = I3G4250D_TransferIO(&gyro, write, sizeof(write));
+    written = I3G4250D_Sim_Register(I3G4250D_INT1_THS_XH_REG) == 0x12 && I3G4250D_Sim_Register(I3G4250D_INT1_THS_XL_REG) == 0x34;
+    TestRelease(&gyro);
+
+    return TestReport(name, readStatus == HAL_OK && writeStatus == HAL_OK && readMatches && written,
+                      "CTRL_REG1..5 read in place %d (CTRL_REG4 0x%02X), threshold written %d",
+                      readMatches, frame[4], written);
+}
@@ -0,0 +1,67 @@
+/*
+SPI clock tuning against the limit of the simulated gyroscope, see I3G4250D_TuneSpiClock.
+*/
+
+#include "I3G4250D_Test.h"
+#include <stdio.h>
+
+bool TestTuneSpiClock(const char *name)
+{
+    static const struct
+    {
+        uint32_t simMaxHz;
+        uint32_t maxHz;
+    } cases[] = {
+        {10000000, I3G4250D_SPI_MAX_HZ}, {10000000, 0}, {50000000, 0}, {50000000, I3G4250D_SPI_MAX_HZ}, {400000, 0}, {100000, I3G4250D_SPI_MAX_HZ},
+    };
+    static I3G4250D_HandleTypeDef gyro;
+    I3G4250D_InitTypeDef init = {0};
+    char detail[128];
+    size_t length = 0;
+    bool pass = true;
+
+    init.ENABLED_AXIS = I3G4250D_ENABLE_ALL_AXIS;
+    init.ODR_BW_PRESET = I3G4250D_ODR_BW_HIGH;
+    init.FULLSCALE_SELECTION = I3G4250D_SCALE_500;
+    init.FIFO_MODE = I3G4250D_FIFO_MODE_STREAM;
+    init.DRDY_MODE = I3G4250D_DRDY_POLLING;
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+    {
+        uint32_t limit = cases[c].maxHz != 0 && cases[c].maxHz < cases[c].simMaxHz ? cases[c].maxHz : cases[c].simMaxHz;
+        uint32_t expected = 0;
+        HAL_StatusTypeDef status;
+        bool match = true;
+
+        // Fastest prescaler the simulated gyroscope keeps up with, none means the original one stays
+        for (uint8_t shift = 1; shift <= 8 && expected == 0; shift++)
+        {
+            if ((HAL_RCC_GetPCLK2Freq() >> shift) <= limit)
+            {
+                expected = HAL_RCC_GetPCLK2Freq() >> shift;
+            }
+        }
+
+        TestReset();
+        I3G4250D_Init(&gyro, &testSpi, GPIOC, GPIO_PIN_1, &init);
+        I3G4250D_Sim_SetMaxSpiClock(cases[c].simMaxHz);
+        testSpi.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_256;
+        status = I3G4250D_TuneSpiClock(&gyro, cases[c].maxHz, 0);
+        for (uint8_t r = 0; r < I3G4250D_SHADOW_SIZE - 2; r++)
+        {
+            match &= I3G4250D_Sim_Register((uint8_t)(I3G4250D_CTRL_REG1 + r)) == gyro.shadow[r];
+        }
+        match &= I3G4250D_Sim_Register(I3G4250D_FIFO_CTRL_REG) == gyro.shadow[I3G4250D_SHADOW_SIZE - 2];
+        if (expected != 0)
+        {
+            pass &= status == HAL_OK && I3G4250D_GetSpiClock(&gyro) == expected && match;
+        }
+        else
+        {
+            pass &= status == HAL_ERROR && testSpi.Init.BaudRatePrescaler == SPI_BAUDRATEPRESCALER_256;
+        }
+        length += (size_t)snprintf(&detail[length], sizeof(detail) - length, "%s%lu -> %lu", c ? ", " : "",
+                                   (unsigned long)(limit / 1000U), (unsigned long)(I3G4250D_GetSpiClock(&gyro) / 1000U));
+        TestRelease(&gyro);
+    }
+    return TestReport(name, pass, "limit -> clock in kHz: %s", detail);
+}